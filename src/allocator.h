@@ -0,0 +1,100 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Caller-supplied memory for the simulations, so a program embedding the schedulers decides where every array
+ * of a run comes from (an arena per run, a pool, a tracking allocator...).
+ *
+ * Every structure taking an allocator keeps a pointer to it until it is freed. A NULL allocator, or one whose
+ * hooks are NULL, uses malloc and free. Running out of memory is a panic, as it always was, that aborts even
+ * when built with NDEBUG.
+ */
+
+/* The hooks of an allocator */
+typedef struct
+{
+    /// A block of at least size bytes aligned to alignment (a power of two), or NULL when out of memory
+    void *(*alloc)(void *user, size_t size, size_t alignment);
+
+    /// Releases a block returned by alloc, never NULL
+    void (*free)(void *user, void *block);
+
+    void *user; // Passed to both hooks
+} sched_allocator_t;
+
+#define SCHED_MIN_ALIGN _Alignof(max_align_t) // The alignment of sched_malloc(), that of malloc()
+
+/// @brief Aborts the program, for an allocation that failed or whose size does not fit in a size_t
+static inline void sched_out_of_memory(void)
+{
+    fputs("sched: out of memory\n", stderr);
+    abort();
+}
+
+/// @brief Allocates size bytes aligned to alignment, at least one byte so that an empty array is not NULL
+static inline void *sched_aligned_alloc(const sched_allocator_t *a, size_t size, size_t alignment)
+{
+    size = size ? size : 1;
+
+    void *block;
+    if (a != NULL && a->alloc != NULL)
+    {
+        block = a->alloc(a->user, size, alignment);
+    }
+    else if (alignment > SCHED_MIN_ALIGN)
+    {
+        block = aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+    else
+    {
+        block = malloc(size);
+    }
+    if (block == NULL)
+    {
+        sched_out_of_memory();
+    }
+    return block;
+}
+
+/// @brief Allocates an array of n elements, like malloc()
+static inline void *sched_malloc(const sched_allocator_t *a, size_t n, size_t element_size)
+{
+    if (element_size && n > SIZE_MAX / element_size)
+    {
+        sched_out_of_memory();
+    }
+    return sched_aligned_alloc(a, n * element_size, SCHED_MIN_ALIGN);
+}
+
+/// @brief Allocates a zeroed array of n elements, like calloc()
+static inline void *sched_calloc(const sched_allocator_t *a, size_t n, size_t element_size)
+{
+    void *block = sched_malloc(a, n, element_size);
+    memset(block, 0, n * element_size);
+    return block;
+}
+
+/// @brief Releases a block of the allocator, NULL does nothing
+static inline void sched_free(const sched_allocator_t *a, void *block)
+{
+    if (block == NULL)
+    {
+        return;
+    }
+    if (a != NULL && a->free != NULL)
+    {
+        a->free(a->user, block);
+    }
+    else
+    {
+        free(block);
+    }
+}
+
+#endif // ALLOCATOR_H
@@ -0,0 +1,352 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "scheduler.h"
+#include "event.h"
+#include "multicore.h"
+#include "workload_gen.h"
+
+/*
+ * Benchmark suite: runs every scheduler over a matrix of generated workloads (see workload_gen.h) of
+ * every arrival distribution and several sizes, and reports for each case the median and 95th percentile
+ * wall time over the repeats, the simulated cycles per second and the peak resident set size.
+ *
+ *   bench [-n max processes] [-t max processes of the tick engines] [-r repeats] [-w warmup runs]
+ *         [-l label] [-o file.json]
+ *
+ * Every case runs in a child process, so its peak RSS is its own. The results are printed as a table and
+ * written as JSON (bench.json by default) along with the label, such as the commit benchmarked, and the
+ * time of the run, to compare across commits.
+ */
+
+/* A scheduler under benchmark */
+typedef struct
+{
+    const char *name;
+    scheduler_result_t (*run)(const sched_context_t *context, process_t *processes, uint32_t n);
+    bool tick; // Simulates every cycle, so it is only run up to the tick size limit
+} bench_scheduler_t;
+
+static scheduler_result_t bench_fcfs(const sched_context_t *c, process_t *p, uint32_t n) { return fcfs(c, p, n); }
+static scheduler_result_t bench_fcfs_event(const sched_context_t *c, process_t *p, uint32_t n) { return fcfs_event(c, p, n); }
+static scheduler_result_t bench_fcfs_k4(const sched_context_t *c, process_t *p, uint32_t n) { return fcfs_multicore(c, p, n, 4); }
+static scheduler_result_t bench_sjf(const sched_context_t *c, process_t *p, uint32_t n) { return sjf(c, p, n); }
+static scheduler_result_t bench_sjf_event(const sched_context_t *c, process_t *p, uint32_t n) { return sjf_event(c, p, n); }
+static scheduler_result_t bench_sjf_k4(const sched_context_t *c, process_t *p, uint32_t n) { return sjf_multicore(c, p, n, 4); }
+static scheduler_result_t bench_rr(const sched_context_t *c, process_t *p, uint32_t n) { return rr(c, p, n, 2, false); }
+static scheduler_result_t bench_rr_event(const sched_context_t *c, process_t *p, uint32_t n) { return rr_event(c, p, n, 2, false); }
+static scheduler_result_t bench_rr_k4(const sched_context_t *c, process_t *p, uint32_t n) { return rr_multicore(c, p, n, 2, false, 4); }
+static scheduler_result_t bench_pri(const sched_context_t *c, process_t *p, uint32_t n) { return priority(c, p, n, false, 8); }
+static scheduler_result_t bench_ppri(const sched_context_t *c, process_t *p, uint32_t n) { return priority(c, p, n, true, 8); }
+static scheduler_result_t bench_srtf(const sched_context_t *c, process_t *p, uint32_t n) { return srtf(c, p, n); }
+static scheduler_result_t bench_mlfq(const sched_context_t *c, process_t *p, uint32_t n)
+{
+    mlfq_config_t config = mlfq_config(3, 2, 100);
+    return mlfq(c, p, n, &config);
+}
+static scheduler_result_t bench_cfs(const sched_context_t *c, process_t *p, uint32_t n)
+{
+    cfs_config_t config = {.target_latency = 24, .min_granularity = 3};
+    return cfs(c, p, n, &config);
+}
+static scheduler_result_t bench_edf(const sched_context_t *c, process_t *p, uint32_t n) { return edf(c, p, n); }
+static scheduler_result_t bench_lottery(const sched_context_t *c, process_t *p, uint32_t n) { return lottery(c, p, n, 2); }
+static scheduler_result_t bench_stride(const sched_context_t *c, process_t *p, uint32_t n) { return stride(c, p, n, 2); }
+
+static const bench_scheduler_t BENCH_SCHEDULERS[] = {
+    {"fcfs", bench_fcfs, true},
+    {"fcfs_event", bench_fcfs_event, false},
+    {"fcfs_k4", bench_fcfs_k4, true},
+    {"sjf", bench_sjf, true},
+    {"sjf_event", bench_sjf_event, false},
+    {"sjf_k4", bench_sjf_k4, true},
+    {"rr", bench_rr, true},
+    {"rr_event", bench_rr_event, false},
+    {"rr_k4", bench_rr_k4, true},
+    {"pri", bench_pri, true},
+    {"ppri", bench_ppri, true},
+    {"srtf", bench_srtf, true},
+    {"mlfq", bench_mlfq, true},
+    {"cfs", bench_cfs, true},
+    {"edf", bench_edf, true},
+    {"lottery", bench_lottery, true},
+    {"stride", bench_stride, true},
+};
+static const uint32_t BENCH_NUM_SCHEDULERS = sizeof(BENCH_SCHEDULERS) / sizeof(BENCH_SCHEDULERS[0]);
+
+static const char *const ARRIVAL_NAMES[] = {"poisson", "bursty", "uniform"};
+
+#define BENCH_MAX_REPEATS 1000
+
+/* What a child process reports for a case */
+typedef struct
+{
+    uint64_t cycles;                     // Cycles simulated by one run
+    double seconds[BENCH_MAX_REPEATS];   // Wall time of every run, sorted
+} bench_runs_t;
+
+/* The results of a case */
+typedef struct
+{
+    const char *scheduler;
+    arrival_dist arrival;
+    uint32_t processes;
+    uint64_t cycles;
+    double median, p95, min;
+    long peak_rss_kb;
+} bench_case_t;
+
+static double now_seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int cmpr_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/// @brief Runs a case `warmup + repeats` times on fresh copies of the workload, timing the repeats
+static void bench_measure(const sched_context_t *context, const bench_scheduler_t *s, const workload_params_t *params,
+                          uint32_t warmup, uint32_t repeats, bench_runs_t *runs)
+{
+    process_t *workload = malloc(sizeof(process_t) * (params->count ? params->count : 1));
+    process_t *processes = malloc(sizeof(process_t) * (params->count ? params->count : 1));
+
+    workload_gen_t g;
+    workload_gen_init(&g, params);
+    for (uint32_t i = 0; i < params->count; i++)
+    {
+        workload_gen_next(&g, &workload[i]);
+    }
+
+    for (uint32_t k = 0; k < warmup + repeats; k++)
+    {
+        memcpy(processes, workload, sizeof(process_t) * params->count);
+
+        double start = now_seconds();
+        scheduler_result_t r = s->run(context, processes, params->count);
+        double seconds = now_seconds() - start;
+
+        if (k >= warmup)
+        {
+            runs->seconds[k - warmup] = seconds;
+        }
+        runs->cycles = r.current_cycle;
+    }
+    qsort(runs->seconds, repeats, sizeof(double), cmpr_double);
+
+    free(workload);
+    free(processes);
+}
+
+/// @brief Measures a case in a child process, so the peak RSS is that of the case alone
+/// @return whether the child succeeded
+static bool bench_case(const sched_context_t *context, const bench_scheduler_t *s, const workload_params_t *params,
+                       uint32_t warmup, uint32_t repeats, bench_case_t *c)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return false;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        return false;
+    }
+    if (pid == 0)
+    {
+        close(fds[0]);
+        bench_runs_t runs;
+        bench_measure(context, s, params, warmup, repeats, &runs);
+        bool sent = write(fds[1], &runs, sizeof(runs)) == (ssize_t)sizeof(runs);
+        _exit(sent ? 0 : 1);
+    }
+
+    close(fds[1]);
+    bench_runs_t runs;
+    size_t got = 0;
+    ssize_t n;
+    while (got < sizeof(runs) && (n = read(fds[0], (char *)&runs + got, sizeof(runs) - got)) > 0)
+    {
+        got += n;
+    }
+    close(fds[0]);
+
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || got != sizeof(runs))
+    {
+        return false;
+    }
+
+    // Nearest rank percentiles of the sorted wall times
+    *c = (bench_case_t){
+        .scheduler = s->name,
+        .arrival = params->arrival,
+        .processes = params->count,
+        .cycles = runs.cycles,
+        .median = repeats % 2 ? runs.seconds[repeats / 2] : (runs.seconds[repeats / 2 - 1] + runs.seconds[repeats / 2]) / 2,
+        .p95 = runs.seconds[(95 * repeats + 99) / 100 - 1],
+        .min = runs.seconds[0],
+        .peak_rss_kb = usage.ru_maxrss,
+    };
+    return true;
+}
+
+static void write_json(FILE *f, const char *label, const bench_case_t *cases, uint32_t num_cases, uint32_t warmup,
+                       uint32_t repeats)
+{
+    char timestamp[32];
+    time_t now = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"label\": \"%s\",\n", label);
+    fprintf(f, "  \"timestamp\": \"%s\",\n", timestamp);
+    fprintf(f, "  \"warmup\": %u,\n", warmup);
+    fprintf(f, "  \"repeats\": %u,\n", repeats);
+    fprintf(f, "  \"results\": [\n");
+    for (uint32_t i = 0; i < num_cases; i++)
+    {
+        const bench_case_t *c = &cases[i];
+        fprintf(f,
+                "    {\"scheduler\": \"%s\", \"arrival\": \"%s\", \"processes\": %u, \"cycles\": %" PRIu64 ", "
+                "\"median_seconds\": %.9f, \"p95_seconds\": %.9f, \"min_seconds\": %.9f, "
+                "\"cycles_per_second\": %.1f, \"peak_rss_kb\": %ld}%s\n",
+                c->scheduler, ARRIVAL_NAMES[c->arrival], c->processes, c->cycles, c->median, c->p95, c->min,
+                c->median > 0 ? c->cycles / c->median : 0.0, c->peak_rss_kb, i + 1 < num_cases ? "," : "");
+    }
+    fprintf(f, "  ]\n");
+    fprintf(f, "}\n");
+}
+
+int main(int argc, char *argv[])
+{
+    // #region PARSE_ARGS
+    uint32_t max_processes = 100000; // -n: the largest workload
+    uint32_t max_tick = 10000;       // -t: the largest workload of the schedulers that simulate every cycle
+    uint32_t repeats = 5;            // -r: timed runs per case
+    uint32_t warmup = 1;             // -w: untimed runs before them
+    const char *label = "";          // -l: what is benchmarked, such as a commit
+    const char *output = "bench.json";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:r:w:l:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            max_processes = strtoul(optarg, NULL, 10);
+            break;
+        case 't':
+            max_tick = strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            repeats = strtoul(optarg, NULL, 10);
+            break;
+        case 'w':
+            warmup = strtoul(optarg, NULL, 10);
+            break;
+        case 'l':
+            label = optarg;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        default:
+            printf("Usage: %s [-n max processes] [-t max processes of the tick engines] [-r repeats] [-w warmup runs] [-l label] [-o file.json]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (repeats < 1 || repeats > BENCH_MAX_REPEATS)
+    {
+        printf("The number of repeats must be between 1 and %u.\n", BENCH_MAX_REPEATS);
+        return 1;
+    }
+    // #endregion PARSE_ARGS
+
+    // #region READ_RANDOM_NUMBERS
+    random_table_t random;
+    if (!random_table_load(&random, RANDOM_NUMBER_FILE_NAME, true, NULL))
+    {
+        printf("Could not read the random numbers from %s.\n", RANDOM_NUMBER_FILE_NAME);
+        return 1;
+    }
+    sched_context_t context = {.random = &random};
+    // #endregion READ_RANDOM_NUMBERS
+
+    // #region RUN_CASES
+    uint32_t max_cases = 0;
+    for (uint32_t n = 10; n <= max_processes; n *= 10)
+    {
+        max_cases += 3 * BENCH_NUM_SCHEDULERS;
+    }
+    bench_case_t *cases = malloc(sizeof(bench_case_t) * (max_cases ? max_cases : 1));
+    uint32_t num_cases = 0;
+
+    printf("%-12s %-8s %10s %12s %12s %12s %14s %10s\n",
+           "scheduler", "arrival", "processes", "cycles", "median s", "p95 s", "cycles/s", "rss KiB");
+
+    for (uint32_t n = 10; n <= max_processes; n *= 10)
+    {
+        for (uint32_t a = 0; a < 3; a++)
+        {
+            workload_params_t params = workload_params_default(n);
+            params.arrival = a;
+            params.deadline_slack = 2.0; // Only EDF looks at the deadlines
+
+            for (uint32_t s = 0; s < BENCH_NUM_SCHEDULERS; s++)
+            {
+                if (BENCH_SCHEDULERS[s].tick && n > max_tick)
+                {
+                    continue;
+                }
+
+                bench_case_t *c = &cases[num_cases];
+                if (!bench_case(&context, &BENCH_SCHEDULERS[s], &params, warmup, repeats, c))
+                {
+                    printf("%s on %u %s processes failed.\n", BENCH_SCHEDULERS[s].name, n, ARRIVAL_NAMES[a]);
+                    return 1;
+                }
+                num_cases++;
+
+                printf("%-12s %-8s %10u %12" PRIu64 " %12.6f %12.6f %14.0f %10ld\n", c->scheduler, ARRIVAL_NAMES[a],
+                       n, c->cycles, c->median, c->p95, c->median > 0 ? c->cycles / c->median : 0.0, c->peak_rss_kb);
+                fflush(stdout);
+            }
+        }
+    }
+    // #endregion RUN_CASES
+
+    // #region WRITE_JSON
+    FILE *f = fopen(output, "w");
+    if (f == NULL)
+    {
+        perror(output);
+        return 1;
+    }
+    write_json(f, label, cases, num_cases, warmup, repeats);
+    if (fclose(f) != 0)
+    {
+        perror(output);
+        return 1;
+    }
+    printf("Wrote %u results to %s\n", num_cases, output);
+    // #endregion WRITE_JSON
+
+    free(cases);
+    random_table_free(&random);
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <time.h>
+
+#include "event.h"
+
+/*
+ * Compares picking the shortest READY job with the ready queue against the linear scan sjf() used to do,
+ * and times the event-driven SJF scheduler end to end, for 1K up to 1M processes.
+ */
+
+static uint32_t bench_rand_state = 2463534242u;
+
+/// @brief xorshift32, so every run benchmarks the same workload
+static uint32_t bench_rand()
+{
+    bench_rand_state ^= bench_rand_state << 13;
+    bench_rand_state ^= bench_rand_state >> 17;
+    bench_rand_state ^= bench_rand_state << 5;
+    return bench_rand_state;
+}
+
+static double now_seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/// @brief Nanoseconds per pick when scanning every READY process for the least remaining time
+static double scan_pick_ns(const uint32_t *remaining, uint32_t n, uint32_t picks)
+{
+    volatile uint32_t sink = 0;
+    double start = now_seconds();
+    for (uint32_t k = 0; k < picks; k++)
+    {
+        uint32_t sj = 0;
+        for (uint32_t i = 1; i < n; i++)
+        {
+            sj = remaining[i] < remaining[sj] ? i : sj;
+        }
+        sink += sj;
+    }
+    return (now_seconds() - start) * 1e9 / picks;
+}
+
+/// @brief Nanoseconds per pick when popping the ready queue and queueing the job again with a new key
+static double heap_pick_ns(const uint32_t *remaining, uint32_t n, uint32_t picks)
+{
+    ready_queue_t q;
+    ready_queue_init(&q, n, NULL);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        ready_queue_push(&q, i, remaining[i]);
+    }
+
+    double start = now_seconds();
+    for (uint32_t k = 0; k < picks; k++)
+    {
+        uint32_t sj = ready_queue_pop(&q);
+        ready_queue_push(&q, sj, bench_rand() % 1000);
+    }
+    double ns = (now_seconds() - start) * 1e9 / picks;
+
+    ready_queue_free(&q);
+    return ns;
+}
+
+/// @brief Seconds taken by sjf_event() on n processes arriving uniformly over n cycles
+static double sjf_event_seconds(const sched_context_t *context, uint32_t n)
+{
+    process_t *processes = malloc(sizeof(process_t) * n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        processes[i] = (process_t){
+            .A = bench_rand() % n,
+            .B = 1 + bench_rand() % 10,
+            .C = 1 + bench_rand() % 20,
+            .M = 1 + bench_rand() % 3,
+            .id = i,
+        };
+    }
+
+    double start = now_seconds();
+    sjf_event(context, processes, n);
+    double seconds = now_seconds() - start;
+
+    free(processes);
+    return seconds;
+}
+
+int main()
+{
+    random_table_t random;
+    if (!random_table_load(&random, RANDOM_NUMBER_FILE_NAME, true, NULL))
+    {
+        printf("Could not read the random numbers from %s.\n", RANDOM_NUMBER_FILE_NAME);
+        return 1;
+    }
+    sched_context_t context = {.random = &random};
+
+    printf("%10s %16s %16s %16s\n", "processes", "scan ns/pick", "heap ns/pick", "sjf_event s");
+
+    for (uint32_t n = 1000; n <= 1000000; n *= 10)
+    {
+        uint32_t *remaining = malloc(sizeof(uint32_t) * n);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            remaining[i] = bench_rand() % 1000;
+        }
+
+        uint32_t scan_picks = 100000000 / n;
+        double scan = scan_pick_ns(remaining, n, scan_picks);
+        double heap = heap_pick_ns(remaining, n, 1000000);
+        double sim = sjf_event_seconds(&context, n);
+
+        printf("%10u %16.1f %16.1f %16.3f\n", n, scan, heap, sim);
+        free(remaining);
+    }
+
+    random_table_free(&random);
+    return 0;
+}
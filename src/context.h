@@ -0,0 +1,24 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "allocator.h"
+#include "random.h"
+#include "sweep.h"
+
+/*
+ * Everything a scheduler reads besides its processes: the random number table the CPU bursts and lottery
+ * tickets are drawn from, the allocator every array of a run comes from, and the sweep kernel of the tick
+ * engines.
+ *
+ * A run only reads its context, so any number of runs may share one context on as many threads, and runs
+ * with different contexts share nothing. The context must outlive the runs using it.
+ */
+
+typedef struct
+{
+    const random_table_t *random; // The table of the random number file, see random.h
+    sched_allocator_t allocator;  // Zeroed for malloc and free
+    sweep_kernel sweep;           // The sweep kernel of the process tables, see sweep.h
+} sched_context_t;
+
+#endif // CONTEXT_H
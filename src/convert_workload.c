@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "loader.h"
+
+/*
+ * Converts a workload between the text input format and the binary workload format (see loader.h).
+ *
+ *   convert_workload [-t] <input> <output>
+ *
+ * The input may be in either format. The output is binary, or text with -t.
+ */
+
+int main(int argc, char *argv[])
+{
+    bool to_text = argc == 4 && strcmp(argv[1], "-t") == 0;
+    if (argc != 3 && !to_text)
+    {
+        fprintf(stderr, "Usage: %s [-t] <input> <output>\n", argv[0]);
+        return 1;
+    }
+
+    const char *input = argv[argc - 2];
+    const char *output = argv[argc - 1];
+
+    process_t *processes;
+    uint32_t total_num_of_process;
+    load_error_t err;
+    if (!load_processes_file(input, &processes, &total_num_of_process, &err))
+    {
+        if (err.line)
+        {
+            fprintf(stderr, "%s:%u:%u: %s\n", input, err.line, err.column, err.message);
+        }
+        else
+        {
+            fprintf(stderr, "%s: %s\n", input, err.message);
+        }
+        return 1;
+    }
+
+    bool saved = to_text ? save_processes_text(output, processes, total_num_of_process)
+                         : save_processes_binary(output, processes, total_num_of_process);
+    free(processes);
+
+    if (!saved)
+    {
+        perror(output);
+        return 1;
+    }
+    return 0;
+}
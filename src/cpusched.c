@@ -0,0 +1,150 @@
+#include "scheduler.h"
+#include "event.h"
+#include "multicore.h"
+#include "cpusched.h"
+
+/*
+ * The one translation unit of libcpusched, see cpusched.h. The headers only define static functions, so they
+ * stay private to the library and only the CPUSCHED_API functions are exported.
+ */
+
+struct cpusched
+{
+    random_table_t random;
+    sched_context_t context; // Draws from `random`
+};
+
+/// @brief Allocates a simulator whose table is yet to be filled in
+static cpusched_t *cpusched_alloc(const sched_allocator_t *allocator)
+{
+    cpusched_t *s = sched_aligned_alloc(allocator, sizeof(cpusched_t), _Alignof(cpusched_t));
+    *s = (cpusched_t){.context = {.random = &s->random}};
+    if (allocator != NULL)
+    {
+        s->context.allocator = *allocator;
+    }
+    return s;
+}
+
+cpusched_t *cpusched_create(const char *random_file, bool write_cache, const sched_allocator_t *allocator)
+{
+    cpusched_t *s = cpusched_alloc(allocator);
+    if (!random_table_load(&s->random, random_file, write_cache, &s->context.allocator))
+    {
+        sched_free(&s->context.allocator, s);
+        return NULL;
+    }
+    return s;
+}
+
+cpusched_t *cpusched_create_from_values(const uint32_t *values, uint32_t count, const sched_allocator_t *allocator)
+{
+    cpusched_t *s = cpusched_alloc(allocator);
+    random_table_init(&s->random, values, count, &s->context.allocator);
+    return s;
+}
+
+void cpusched_destroy(cpusched_t *s)
+{
+    sched_allocator_t allocator = s->context.allocator;
+    random_table_free(&s->random);
+    sched_free(&allocator, s);
+}
+
+/********************* SINGLE-CORE *********************/
+
+scheduler_result_t cpusched_fcfs(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process)
+{
+    return fcfs(&s->context, processes, total_num_of_process);
+}
+
+scheduler_result_t cpusched_sjf(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process)
+{
+    return sjf(&s->context, processes, total_num_of_process);
+}
+
+scheduler_result_t cpusched_srtf(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process)
+{
+    return srtf(&s->context, processes, total_num_of_process);
+}
+
+scheduler_result_t cpusched_edf(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process)
+{
+    return edf(&s->context, processes, total_num_of_process);
+}
+
+scheduler_result_t cpusched_rr(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                               uint8_t quantum, bool preemptive)
+{
+    return rr(&s->context, processes, total_num_of_process, quantum, preemptive);
+}
+
+scheduler_result_t cpusched_priority(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                     bool preemptive, uint32_t aging_interval)
+{
+    return priority(&s->context, processes, total_num_of_process, preemptive, aging_interval);
+}
+
+scheduler_result_t cpusched_mlfq(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                 uint32_t num_levels, uint32_t quantum, uint32_t boost_interval)
+{
+    mlfq_config_t config = mlfq_config(num_levels, quantum, boost_interval);
+    return mlfq(&s->context, processes, total_num_of_process, &config);
+}
+
+scheduler_result_t cpusched_cfs(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                uint32_t target_latency, uint32_t min_granularity)
+{
+    cfs_config_t config = {.target_latency = target_latency, .min_granularity = min_granularity};
+    return cfs(&s->context, processes, total_num_of_process, &config);
+}
+
+scheduler_result_t cpusched_lottery(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                    uint8_t quantum)
+{
+    return lottery(&s->context, processes, total_num_of_process, quantum);
+}
+
+scheduler_result_t cpusched_stride(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                   uint8_t quantum)
+{
+    return stride(&s->context, processes, total_num_of_process, quantum);
+}
+
+/********************* EVENT-DRIVEN *********************/
+
+scheduler_result_t cpusched_fcfs_event(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process)
+{
+    return fcfs_event(&s->context, processes, total_num_of_process);
+}
+
+scheduler_result_t cpusched_sjf_event(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process)
+{
+    return sjf_event(&s->context, processes, total_num_of_process);
+}
+
+scheduler_result_t cpusched_rr_event(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                     uint8_t quantum, bool preemptive)
+{
+    return rr_event(&s->context, processes, total_num_of_process, quantum, preemptive);
+}
+
+/********************* MULTI-CORE *********************/
+
+scheduler_result_t cpusched_fcfs_multicore(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                           uint32_t num_cores)
+{
+    return fcfs_multicore(&s->context, processes, total_num_of_process, num_cores);
+}
+
+scheduler_result_t cpusched_sjf_multicore(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                          uint32_t num_cores)
+{
+    return sjf_multicore(&s->context, processes, total_num_of_process, num_cores);
+}
+
+scheduler_result_t cpusched_rr_multicore(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                         uint8_t quantum, bool preemptive, uint32_t num_cores)
+{
+    return rr_multicore(&s->context, processes, total_num_of_process, quantum, preemptive, num_cores);
+}
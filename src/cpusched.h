@@ -0,0 +1,102 @@
+#ifndef CPUSCHED_H
+#define CPUSCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "process.h"
+#include "allocator.h"
+
+/*
+ * libcpusched, the schedulers as a library to embed in another program (make libcpusched).
+ *
+ * This header only declares: the definitions are compiled once into libcpusched.a and libcpusched.so, from
+ * cpusched.c, which export nothing but the functions below.
+ *
+ * A simulator (cpusched_t) holds a random number table and the allocator every run takes its memory from. A
+ * run only reads its simulator and keeps no other state, so any number of runs may use one simulator at the
+ * same time on as many threads, and simulators share nothing. A run takes the processes to schedule with their
+ * input fields set (A, B, C, M, id, and priority, deadline and tickets where used) and everything else zeroed,
+ * as (process_t){.id = i, ...} does, and leaves them sorted by arrival with their statistics filled in, exactly
+ * like the simulator does with an input file.
+ *
+ * The library is built without SCHED_PROFILE, so it must not be defined when including this header.
+ */
+
+#ifdef SCHED_PROFILE
+#error "libcpusched is built without SCHED_PROFILE, its scheduler_result_t has no profile"
+#endif
+
+#define CPUSCHED_API __attribute__((visibility("default")))
+
+typedef struct cpusched cpusched_t;
+
+/// @brief Creates a simulator drawing from a random number file, in the format of random-numbers
+/// @param write_cache whether to write the binary sidecar random_file.bin when it is missing or out of date,
+/// which makes the next load faster. An up-to-date sidecar is read either way
+/// @param allocator where the simulator, the table and every run take their memory from, copied; NULL for malloc
+/// @return the simulator, or NULL if the file could not be read
+CPUSCHED_API cpusched_t *cpusched_create(const char *random_file, bool write_cache,
+                                         const sched_allocator_t *allocator);
+
+/// @brief Creates a simulator drawing from a copy of the given numbers, values[i] standing for line i + 1 of
+/// a random number file
+/// @param allocator where the simulator, the table and every run take their memory from, copied; NULL for malloc
+CPUSCHED_API cpusched_t *cpusched_create_from_values(const uint32_t *values, uint32_t count,
+                                                     const sched_allocator_t *allocator);
+
+/// @brief Frees a simulator, once no run uses it
+CPUSCHED_API void cpusched_destroy(cpusched_t *s);
+
+/* The single-core schedulers, see scheduler.h */
+CPUSCHED_API scheduler_result_t cpusched_fcfs(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process);
+CPUSCHED_API scheduler_result_t cpusched_sjf(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process);
+CPUSCHED_API scheduler_result_t cpusched_srtf(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process);
+CPUSCHED_API scheduler_result_t cpusched_edf(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process);
+
+/// @param quantum the time quantum, at least 1
+/// @param preemptive whether to preempt at the end of the quantum rather than block after every cycle
+CPUSCHED_API scheduler_result_t cpusched_rr(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                            uint8_t quantum, bool preemptive);
+
+/// @param aging_interval the cycles waited per step of aging, 0 disables aging
+CPUSCHED_API scheduler_result_t cpusched_priority(const cpusched_t *s, process_t *processes,
+                                                  uint32_t total_num_of_process, bool preemptive,
+                                                  uint32_t aging_interval);
+
+/// @param num_levels the levels, 1 .. MAX_LEVELS, whose quantum doubles from the first level's `quantum`
+/// @param boost_interval the cycles between two boosts to level 0, 0 disables boosts
+CPUSCHED_API scheduler_result_t cpusched_mlfq(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                              uint32_t num_levels, uint32_t quantum, uint32_t boost_interval);
+
+/// @param target_latency the period in which every runnable process should run once, at least 1
+/// @param min_granularity the shortest slice, at least 1
+CPUSCHED_API scheduler_result_t cpusched_cfs(const cpusched_t *s, process_t *processes, uint32_t total_num_of_process,
+                                             uint32_t target_latency, uint32_t min_granularity);
+
+/// @param quantum the most cycles a process runs before the next lottery, at least 1
+CPUSCHED_API scheduler_result_t cpusched_lottery(const cpusched_t *s, process_t *processes,
+                                                 uint32_t total_num_of_process, uint8_t quantum);
+
+/// @param quantum the most cycles a process runs before the passes are compared, at least 1
+CPUSCHED_API scheduler_result_t cpusched_stride(const cpusched_t *s, process_t *processes,
+                                                uint32_t total_num_of_process, uint8_t quantum);
+
+/* The event-driven engine, with the same results as the tick engine, see event.h */
+CPUSCHED_API scheduler_result_t cpusched_fcfs_event(const cpusched_t *s, process_t *processes,
+                                                    uint32_t total_num_of_process);
+CPUSCHED_API scheduler_result_t cpusched_sjf_event(const cpusched_t *s, process_t *processes,
+                                                   uint32_t total_num_of_process);
+CPUSCHED_API scheduler_result_t cpusched_rr_event(const cpusched_t *s, process_t *processes,
+                                                  uint32_t total_num_of_process, uint8_t quantum,
+                                                  bool preemptive);
+
+/* The multi-core schedulers, on 1 .. MAX_CORES cores, see multicore.h */
+CPUSCHED_API scheduler_result_t cpusched_fcfs_multicore(const cpusched_t *s, process_t *processes,
+                                                        uint32_t total_num_of_process, uint32_t num_cores);
+CPUSCHED_API scheduler_result_t cpusched_sjf_multicore(const cpusched_t *s, process_t *processes,
+                                                       uint32_t total_num_of_process, uint32_t num_cores);
+CPUSCHED_API scheduler_result_t cpusched_rr_multicore(const cpusched_t *s, process_t *processes,
+                                                      uint32_t total_num_of_process, uint8_t quantum,
+                                                      bool preemptive, uint32_t num_cores);
+
+#endif // CPUSCHED_H
@@ -0,0 +1,159 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "process.h"
+#include "process_table.h"
+#include "trace.h"
+
+/*
+ * The tick engine shared by every single-core scheduler. It simulates one cycle at a time over a
+ * process_table_t, in the same phases for every policy:
+ *   1. Unstarted -> Ready for the processes arriving this cycle
+ *   2. a sweep moving Blocked -> Ready and counting a cycle of waiting for every READY process
+ *   3. the running process(es) run for the cycle, then leave the CPU if they terminate, block or are preempted
+ *   4. Ready -> Running for the process the policy picks, which then first runs on the following cycle
+ * The dispatched process was counted as waiting in phase 2 and gets that cycle back. A process draws a new
+ * CPU burst when dispatched unless it was preempted with some of its burst left.
+ *
+ * What sets the schedulers apart is a scheduler_policy_t of hooks. The engine is always inlined and the
+ * policies are constant, so every hook is inlined into the loop of its scheduler as if written out by hand.
+ */
+
+/* The hooks of a scheduling policy, a NULL hook does nothing */
+typedef struct
+{
+    /// A process became READY: it arrived, woke up from I/O or was preempted
+    void (*enqueue)(void *state, process_table_t *t, uint32_t i);
+
+    /// Once per cycle after the sweep, before anything runs
+    void (*age)(void *state, process_table_t *t);
+
+    /// A running process ran a cycle, including the cycle it terminates or blocks on. It may block a process
+    /// that is still RUNNING, which then leaves the CPU
+    void (*tick)(void *state, process_table_t *t, uint32_t i);
+
+    /// Whether a running process that ran this cycle and did not terminate or block goes back to READY now,
+    /// keeping the rest of its burst
+    bool (*preempt)(void *state, process_table_t *t, uint32_t i);
+
+    /// The READY process to dispatch, which the policy stops tracking as READY, or NO_PROCESS to dispatch none.
+    /// scan_from is just after the process that left the CPU this cycle, 0 when none did.
+    uint32_t (*pick)(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running);
+} scheduler_policy_t;
+
+/// @brief Simulates the processes under a policy until every process has terminated
+/// @param context where the bursts are drawn from and the memory of the run comes from, see context.h
+/// @param state the policy's own data, passed to every hook
+/// @param trace the log to record every cycle in, or NULL
+static inline __attribute__((always_inline)) scheduler_result_t
+engine_run(const sched_context_t *context, process_t *processes, uint32_t total_num_of_process,
+           const scheduler_policy_t *policy, void *state, trace_log_t *trace)
+{
+    qsort(processes, total_num_of_process, sizeof(process_t), cmpr_process_a);
+
+    process_table_t t;
+    process_table_init(&t, processes, total_num_of_process, context);
+
+    scheduler_result_t r = {0}; // Result of the scheduler
+    uint32_t next_arrival = 0;  // First process that has not arrived yet
+
+    // The running processes, only SJF ever runs more than one
+    uint32_t *running = sched_malloc(&context->allocator, total_num_of_process, sizeof(uint32_t));
+    uint32_t num_running = 0;
+
+    PROFILE_CLOCK(start);
+    PROFILE_CLOCK(lap);
+    while (r.total_finished_processes < total_num_of_process)
+    {
+        if (trace)
+        {
+            trace_log_cycle(trace, &t);
+        }
+
+        // Unstarted -> Ready
+        uint32_t arrived = process_table_arrive(&t, next_arrival, r.current_cycle);
+        r.total_created_processes += arrived - next_arrival;
+        for (; policy->enqueue && next_arrival < arrived; next_arrival++)
+        {
+            policy->enqueue(state, &t, next_arrival);
+            PROFILE_ADD(&r, enqueues, 1);
+        }
+        next_arrival = arrived;
+        PROFILE_LAP(&r, PHASE_ARRIVE, lap);
+
+        // Blocked -> Ready, Ready
+        r.total_number_of_cycles_spent_blocked += process_table_sweep(&t);
+        for (uint32_t i = policy->enqueue ? process_table_next_woken(&t, 0) : NO_PROCESS; i != NO_PROCESS;
+             i = process_table_next_woken(&t, i + 1))
+        {
+            policy->enqueue(state, &t, i);
+            PROFILE_ADD(&r, enqueues, 1);
+        }
+        PROFILE_LAP(&r, PHASE_SWEEP, lap);
+
+        if (policy->age)
+        {
+            policy->age(state, &t);
+        }
+        PROFILE_LAP(&r, PHASE_AGE, lap);
+
+        // Running -> Terminate or Block, or Running -> Ready when preempted
+        PROFILE_ADD(&r, idle_cycles, num_running == 0);
+        uint32_t scan_from = 0;
+        for (uint32_t k = 0; k < num_running;)
+        {
+            uint32_t i = running[k];
+            bool left = process_table_run(&t, i, &r);
+            if (policy->tick)
+            {
+                policy->tick(state, &t, i);
+                left = t.status[i] != RUNNING;
+            }
+            if (!left)
+            {
+                if (!policy->preempt || !policy->preempt(state, &t, i))
+                {
+                    k++;
+                    continue;
+                }
+
+                t.status[i] = READY;
+                r.total_preemptions++;
+                if (policy->enqueue)
+                {
+                    policy->enqueue(state, &t, i);
+                    PROFILE_ADD(&r, enqueues, 1);
+                }
+            }
+
+            scan_from = i + 1;
+            running[k] = running[--num_running];
+        }
+        PROFILE_LAP(&r, PHASE_RUN, lap);
+
+        // Ready -> Running
+        uint32_t i = policy->pick(state, &t, scan_from, num_running);
+        PROFILE_ADD(&r, picks, 1);
+        if (i != NO_PROCESS)
+        {
+            PROFILE_ADD(&r, burst_draws, t.cpu_burst[i] == 0);
+            process_table_dispatch(&t, i, t.cpu_burst[i] == 0);
+            running[num_running++] = i;
+            r.total_context_switches++;
+        }
+        PROFILE_LAP(&r, PHASE_PICK, lap);
+
+        r.current_cycle++;
+    }
+    PROFILE_TOTAL(&r, start);
+
+    process_table_store(&t, processes);
+    process_table_free(&t);
+    sched_free(&context->allocator, running);
+    return r;
+}
+
+#endif // ENGINE_H
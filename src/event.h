@@ -0,0 +1,287 @@
+#ifndef EVENT_H
+#define EVENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "scheduler.h"
+#include "timer_wheel.h"
+
+/*
+ * Discrete-event (next-event) versions of fcfs(), sjf() and rr().
+ *
+ * Instead of advancing one cycle at a time and walking every process, the engine jumps straight to
+ * the next cycle where something changes: an arrival, the end of a CPU burst, an I/O completion or
+ * the end of an RR run. Every process has at most one of these pending, kept in a timer wheel (see
+ * timer_wheel.h) keyed by the cycle it fires on. Time spent in a state is accumulated in bulk when the
+ * state is left, so the per-process stats and the scheduler_result_t match the tick engine exactly.
+ *
+ * Like the tick engine, the multiplier M is assumed to be at least 1.
+ */
+
+typedef enum
+{
+    POLICY_FCFS = 0,
+    POLICY_SJF = 1,
+    POLICY_RR = 2,           // RR blocking after every cycle, see rr()
+    POLICY_RR_PREEMPTIVE = 3 // RR preempting at the end of the quantum
+} event_policy;
+
+/// @brief Calculates the CPU burst time and the IO burst time for a given process
+static inline void set_bursts(process_t *p, const random_table_t *random)
+{
+    p->cpu_burst = randomOS(random, p->B, p->id);
+    p->io_burst = p->cpu_burst * p->M;
+}
+
+/// @brief Moves a process to READY, queueing it by remaining CPU time for SJF and by index otherwise
+static inline void event_make_ready(process_t *p, uint32_t indx, event_policy policy, ready_set_t *ready, ready_queue_t *shortest)
+{
+    p->status = READY;
+    if (policy == POLICY_SJF)
+    {
+        ready_queue_push(shortest, indx, p->C - p->cpu_time);
+    }
+    else
+    {
+        ready_set_add(ready, indx);
+    }
+}
+
+/// @brief Schedules the end of a run starting at the given cycle: the end of the CPU burst, the end of the
+/// quantum for preemptive RR, or termination, whichever comes first. RR otherwise runs for a single cycle.
+static inline void event_run(const process_t *p, uint32_t indx, uint64_t cycle, event_policy policy, uint8_t quantum,
+                             timer_wheel_t *timers)
+{
+    // The tick engine checks for termination before the end of the burst
+    uint32_t until_done = p->C > p->cpu_time ? p->C - p->cpu_time : 1;
+    uint32_t run = p->cpu_burst < until_done ? p->cpu_burst : until_done;
+    if (policy == POLICY_RR)
+    {
+        run = 1;
+    }
+    else if (policy == POLICY_RR_PREEMPTIVE && quantum < run)
+    {
+        run = quantum;
+    }
+
+    timer_wheel_insert(timers, indx, cycle + run);
+}
+
+/// @brief Moves a READY process to RUNNING at the given cycle and schedules the end of its run.
+///
+/// A process dispatched on cycle t first runs on cycle t + 1, exactly as in the tick engine. A process
+/// preempted by RR resumes its CPU burst instead of drawing a new one.
+static inline void event_dispatch(const sched_context_t *context, process_t *p, uint32_t indx, uint64_t cycle,
+                                  uint64_t ready_since, event_policy policy, uint8_t quantum, timer_wheel_t *timers)
+{
+    p->waiting_time += cycle - ready_since;
+
+    if (p->cpu_burst == 0)
+    {
+        set_bursts(p, context->random);
+    }
+    p->status = RUNNING;
+
+    event_run(p, indx, cycle, policy, quantum, timers);
+}
+
+/// @brief Event-driven scheduler producing the same results as fcfs(), sjf() or rr()
+/// @param quantum the time quantum, only used by POLICY_RR_PREEMPTIVE
+static inline scheduler_result_t event_schedule(const sched_context_t *context, process_t *processes,
+                                                uint32_t total_num_of_process, event_policy policy, uint8_t quantum)
+{
+    qsort(processes, total_num_of_process, sizeof(process_t), cmpr_process_a);
+
+    const sched_allocator_t *allocator = &context->allocator;
+    scheduler_result_t r = {0}; // Result of the scheduler
+
+    timer_wheel_t timers; // Pending arrivals, run ends and I/O completions
+    timer_wheel_init(&timers, total_num_of_process, 0, allocator);
+
+    ready_set_t ready; // READY processes by index (FCFS and RR)
+    ready_set_init(&ready, total_num_of_process, allocator);
+
+    ready_queue_t shortest; // READY processes by remaining CPU time (SJF only)
+    ready_queue_init(&shortest, total_num_of_process, allocator);
+
+    uint64_t *ready_since = sched_malloc(allocator, total_num_of_process, sizeof(uint64_t));
+
+    for (uint32_t i = 0; i < total_num_of_process; i++)
+    {
+        timer_wheel_insert(&timers, i, processes[i].A);
+    }
+
+    bool cpu_busy = false;  // Whether a process is running (FCFS and RR only)
+    uint64_t scan_from = 0; // Where the circular scan of the tick engine starts for the next dispatch
+    uint64_t cycle = 0;
+
+    PROFILE_CLOCK(start);
+    while (r.total_finished_processes < total_num_of_process)
+    {
+        // Jump to the next cycle where something happens, SJF dispatches every cycle while processes are READY
+        uint64_t limit = ready_queue_empty(&shortest) ? TIMER_WHEEL_NEVER : cycle + 1;
+        uint64_t next = timer_wheel_next(&timers, limit);
+        assert(next != TIMER_WHEEL_NEVER || limit != TIMER_WHEEL_NEVER);
+        cycle = next != TIMER_WHEEL_NEVER ? next : limit;
+
+        // Idle CPUs scan from the head, a CPU freed this cycle scans from the process after it
+        scan_from = 0;
+
+        uint32_t expired = NO_PROCESS; // RR: the running process whose quantum ended this cycle
+
+        uint32_t i;
+        while (timer_wheel_pop(&timers, cycle, &i))
+        {
+            process_t *p = &processes[i];
+            PROFILE_ADD(&r, events, 1);
+
+            // Unstarted -> Ready
+            if (p->status == UNSTARTED)
+            {
+                p->cpu_time = 0;
+                p->blocked_time = 0;
+                p->waiting_time = 0;
+                p->cpu_burst = 0;
+                p->is_first_run = true;
+
+                event_make_ready(p, i, policy, &ready, &shortest);
+                PROFILE_ADD(&r, enqueues, 1);
+                ready_since[i] = cycle;
+
+                r.total_created_processes++;
+            }
+
+            // Blocked -> Ready
+            else if (p->status == BLOCKED)
+            {
+                event_make_ready(p, i, policy, &ready, &shortest);
+                PROFILE_ADD(&r, enqueues, 1);
+                ready_since[i] = cycle;
+            }
+
+            // Running -> Terminated, Blocked, or the end of the quantum
+            else if (p->status == RUNNING)
+            {
+                uint32_t ran = (uint32_t)(cycle - ready_since[i]);
+                p->cpu_time += ran;
+                p->cpu_burst -= ran;
+                if (p->is_first_run)
+                {
+                    r.total_started_processes++;
+                    record_first_run(&r, ready_since[i], p->A);
+                    p->is_first_run = false;
+                }
+
+                if (p->cpu_time >= p->C)
+                {
+                    p->status = TERMINATED;
+                    p->finished_time = cycle;
+
+                    r.total_finished_processes++;
+                    record_termination(&r, cycle - p->A, p->waiting_time, p->blocked_time);
+                }
+                else if (p->cpu_burst == 0 || policy == POLICY_RR)
+                {
+                    // Non-preemptive RR blocks after every cycle, for the I/O of its whole burst
+                    p->cpu_burst = 0;
+                    p->status = BLOCKED;
+                    p->blocked_time += p->io_burst;
+                    r.total_number_of_cycles_spent_blocked += p->io_burst;
+
+                    timer_wheel_insert(&timers, i, cycle + p->io_burst);
+                }
+                else
+                {
+                    expired = i;
+                    continue;
+                }
+
+                cpu_busy = false;
+                scan_from = i + 1;
+            }
+        }
+
+        // Running -> Ready at the end of the quantum once every arrival and wake-up of the cycle is READY,
+        // unless no other process is READY and the quantum starts over
+        if (expired != NO_PROCESS)
+        {
+            if (ready.size)
+            {
+                // It ran this cycle, so its waiting starts on the next one
+                event_make_ready(&processes[expired], expired, policy, &ready, &shortest);
+                PROFILE_ADD(&r, enqueues, 1);
+                ready_since[expired] = cycle + 1;
+                r.total_preemptions++;
+                cpu_busy = false;
+                scan_from = expired + 1;
+            }
+            else
+            {
+                event_run(&processes[expired], expired, cycle, policy, quantum, &timers);
+                ready_since[expired] = cycle;
+            }
+        }
+
+        // Ready -> Running
+        if (!ready_queue_empty(&shortest))
+        {
+            i = ready_queue_pop(&shortest);
+        }
+        else if (ready.size && !cpu_busy)
+        {
+            i = ready_set_next(&ready, scan_from % total_num_of_process);
+            ready_set_remove(&ready, i);
+            cpu_busy = true;
+        }
+        else
+        {
+            continue;
+        }
+        PROFILE_ADD(&r, picks, 1);
+        PROFILE_ADD(&r, burst_draws, processes[i].cpu_burst == 0);
+
+        event_dispatch(context, &processes[i], i, cycle, ready_since[i], policy, quantum, &timers);
+        r.total_context_switches++;
+
+        // While running, ready_since holds the dispatch cycle to measure the length of the run
+        ready_since[i] = cycle;
+    }
+
+    r.current_cycle = total_num_of_process ? cycle + 1 : 0;
+    PROFILE_TOTAL(&r, start);
+
+    timer_wheel_free(&timers);
+    ready_set_free(&ready);
+    ready_queue_free(&shortest);
+    sched_free(allocator, ready_since);
+    return r;
+}
+
+/// @brief Event-driven First-Come-First-Serve (FCFS) Scheduler, see fcfs()
+static inline scheduler_result_t fcfs_event(const sched_context_t *context, process_t *processes,
+                                            uint32_t total_num_of_process)
+{
+    return event_schedule(context, processes, total_num_of_process, POLICY_FCFS, 0);
+}
+
+/// @brief Event-driven Shortest Job First (SJF) Scheduler, see sjf()
+static inline scheduler_result_t sjf_event(const sched_context_t *context, process_t *processes,
+                                           uint32_t total_num_of_process)
+{
+    return event_schedule(context, processes, total_num_of_process, POLICY_SJF, 0);
+}
+
+/// @brief Event-driven Round Robin (RR) Scheduler, see rr()
+/// @param quantum the time quantum for the scheduler
+/// @param preemptive whether to preempt at the end of the quantum rather than block after every cycle
+static inline scheduler_result_t rr_event(const sched_context_t *context, process_t *processes,
+                                          uint32_t total_num_of_process, uint8_t quantum, bool preemptive)
+{
+    event_policy policy = preemptive ? POLICY_RR_PREEMPTIVE : POLICY_RR;
+    return event_schedule(context, processes, total_num_of_process, policy, quantum);
+}
+
+#endif // EVENT_H
@@ -0,0 +1,85 @@
+#ifndef FENWICK_H
+#define FENWICK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "allocator.h"
+
+/*
+ * Fenwick (binary indexed) tree of a weight per process, used by the lottery scheduler to hold the tickets
+ * of the READY processes.
+ *
+ * Changing a weight and finding the process holding the k-th unit of weight, in index order, are both
+ * O(log N): the tree stores at node i the sum of the weights of the processes i - lowbit(i) .. i - 1, and
+ * the search descends from the highest power of two, skipping every node whose sum lies below k.
+ */
+
+typedef struct
+{
+    uint64_t *tree;   // 1-based, tree[i] is the sum over the lowbit(i) processes ending at process i - 1
+    uint32_t size;    // The number of processes
+    uint32_t top_bit; // The highest power of two not above size
+    uint64_t total;   // The sum of every weight
+
+    const sched_allocator_t *allocator; // Where the tree comes from
+} fenwick_t;
+
+/// @brief Allocates a tree of zero weights for the processes 0 .. total_num_of_process - 1
+/// @param allocator where the tree comes from, NULL for malloc
+static inline void fenwick_init(fenwick_t *f, uint32_t total_num_of_process, const sched_allocator_t *allocator)
+{
+    f->allocator = allocator;
+    f->tree = sched_calloc(allocator, (size_t)total_num_of_process + 1, sizeof(uint64_t));
+    f->size = total_num_of_process;
+    f->top_bit = 1;
+    while (f->top_bit <= total_num_of_process / 2)
+    {
+        f->top_bit <<= 1;
+    }
+    f->total = 0;
+}
+
+static inline void fenwick_free(fenwick_t *f)
+{
+    sched_free(f->allocator, f->tree);
+    *f = (fenwick_t){0};
+}
+
+/// @brief Adds delta to the weight of a process, a negative delta must not take it below 0
+static inline void fenwick_add(fenwick_t *f, uint32_t indx, int64_t delta)
+{
+    for (uint32_t i = indx + 1; i <= f->size; i += i & -i)
+    {
+        f->tree[i] += (uint64_t)delta;
+    }
+    f->total += (uint64_t)delta;
+}
+
+/// @brief The sum of the weights of the processes 0 .. indx - 1
+static inline uint64_t fenwick_prefix(const fenwick_t *f, uint32_t indx)
+{
+    uint64_t sum = 0;
+    for (uint32_t i = indx; i > 0; i -= i & -i)
+    {
+        sum += f->tree[i];
+    }
+    return sum;
+}
+
+/// @brief The process holding unit k of the weights laid end to end in index order, k < total
+static inline uint32_t fenwick_find(const fenwick_t *f, uint64_t k)
+{
+    uint32_t pos = 0;
+    for (uint32_t step = f->top_bit; step; step >>= 1)
+    {
+        if (pos + step <= f->size && f->tree[pos + step] <= k)
+        {
+            pos += step;
+            k -= f->tree[pos];
+        }
+    }
+    return pos;
+}
+
+#endif // FENWICK_H
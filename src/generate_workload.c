@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "loader.h"
+#include "workload_gen.h"
+
+/*
+ * Writes a synthetic workload (see workload_gen.h) in the text or the binary input format.
+ *
+ *   generate_workload -n count [-a poisson|bursty|uniform] [-g mean gap] [-b burst size] [-B max B]
+ *                     [-c min C] [-C max C] [-x tail] [-M max M] [-P max priority] [-d deadline slack]
+ *                     [-T max tickets] [-s seed] [-t] <output>
+ *
+ * The same options and seed always give the same workload. The output is binary, or text with -t.
+ */
+
+#define USAGE "Usage: %s -n count [-a poisson|bursty|uniform] [-g mean gap] [-b burst size] [-B max B] " \
+              "[-c min C] [-C max C] [-x tail] [-M max M] [-P max priority] [-d deadline slack] [-T max tickets] " \
+              "[-s seed] [-t] <output>\n"
+
+/// @brief The fields of every record: up to the last optional field the workload has
+static uint32_t workload_gen_num_fields(const workload_params_t *params)
+{
+    return params->max_tickets ? 7 : params->deadline_slack > 0 ? 6 : params->max_priority ? 5 : 4;
+}
+
+/// @brief Writes the workload in the binary format, generating it twice to find the narrowest field width first
+static bool write_binary(FILE *f, const workload_params_t *params)
+{
+    workload_gen_t g;
+    process_t p;
+    uint32_t num_fields = workload_gen_num_fields(params);
+
+    uint32_t max = 0;
+    workload_gen_init(&g, params);
+    for (uint32_t i = 0; i < params->count; i++)
+    {
+        workload_gen_next(&g, &p);
+        uint32_t values[WORKLOAD_MAX_FIELDS] = {p.A, p.B, p.C, p.M, p.priority, p.deadline, p.tickets};
+        for (uint32_t k = 0; k < num_fields; k++)
+        {
+            max = values[k] > max ? values[k] : max;
+        }
+    }
+    uint32_t width = workload_field_width(max);
+
+    bool written = save_workload_header(f, params->count, num_fields, width);
+    workload_gen_init(&g, params);
+    for (uint32_t i = 0; written && i < params->count; i++)
+    {
+        workload_gen_next(&g, &p);
+        uint32_t values[WORKLOAD_MAX_FIELDS] = {p.A, p.B, p.C, p.M, p.priority, p.deadline, p.tickets};
+        written = save_workload_record(f, values, num_fields, width);
+    }
+    return written;
+}
+
+static bool write_text(FILE *f, const workload_params_t *params)
+{
+    workload_gen_t g;
+    process_t p;
+    uint32_t num_fields = workload_gen_num_fields(params);
+    workload_gen_init(&g, params);
+
+    fprintf(f, "%u\n", params->count);
+    for (uint32_t i = 0; i < params->count; i++)
+    {
+        workload_gen_next(&g, &p);
+        uint32_t values[WORKLOAD_MAX_FIELDS] = {p.A, p.B, p.C, p.M, p.priority, p.deadline, p.tickets};
+        for (uint32_t k = 0; k < num_fields; k++)
+        {
+            fprintf(f, k ? " %u" : "(%u", values[k]);
+        }
+        fprintf(f, ")\n");
+    }
+    return !ferror(f);
+}
+
+int main(int argc, char *argv[])
+{
+    // #region PARSE_ARGS
+    workload_params_t params = workload_params_default(0);
+    bool have_count = false;
+    bool text = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:a:g:b:B:c:C:x:M:P:d:T:s:t")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            params.count = strtoul(optarg, NULL, 10);
+            have_count = true;
+            break;
+        case 'a':
+            if (strcmp(optarg, "poisson") == 0)
+            {
+                params.arrival = ARRIVAL_POISSON;
+            }
+            else if (strcmp(optarg, "bursty") == 0)
+            {
+                params.arrival = ARRIVAL_BURSTY;
+            }
+            else if (strcmp(optarg, "uniform") == 0)
+            {
+                params.arrival = ARRIVAL_UNIFORM;
+            }
+            else
+            {
+                printf("Unknown arrival distribution %s, expected poisson, bursty or uniform.\n", optarg);
+                return 1;
+            }
+            break;
+        case 'g':
+            params.mean_gap = strtod(optarg, NULL);
+            break;
+        case 'b':
+            params.burst_size = strtod(optarg, NULL);
+            break;
+        case 'B':
+            params.max_B = strtoul(optarg, NULL, 10);
+            break;
+        case 'c':
+            params.min_C = strtoul(optarg, NULL, 10);
+            break;
+        case 'C':
+            params.max_C = strtoul(optarg, NULL, 10);
+            break;
+        case 'x':
+            params.tail = strtod(optarg, NULL);
+            break;
+        case 'M':
+            params.max_M = strtoul(optarg, NULL, 10);
+            break;
+        case 'P':
+            params.max_priority = strtoul(optarg, NULL, 10);
+            break;
+        case 'd':
+            params.deadline_slack = strtod(optarg, NULL);
+            break;
+        case 'T':
+            params.max_tickets = strtoul(optarg, NULL, 10);
+            break;
+        case 's':
+            params.seed = strtoull(optarg, NULL, 10);
+            break;
+        case 't':
+            text = true;
+            break;
+        default:
+            printf(USAGE, argv[0]);
+            return 1;
+        }
+    }
+
+    if (!have_count || optind != argc - 1)
+    {
+        printf(USAGE, argv[0]);
+        return 1;
+    }
+    if (params.mean_gap < 0 || params.burst_size < 1 || params.tail <= 0 || params.deadline_slack < 0)
+    {
+        printf("The mean gap and deadline slack must not be negative, the burst size must be at least 1 and the tail positive.\n");
+        return 1;
+    }
+    if (params.max_B < 1 || params.max_M < 1 || params.min_C < 1 || params.min_C > params.max_C)
+    {
+        printf("B, C and M must be at least 1, and min C at most max C.\n");
+        return 1;
+    }
+    // #endregion PARSE_ARGS
+
+    // #region WRITE_WORKLOAD
+    const char *output = argv[optind];
+    FILE *f = fopen(output, text ? "w" : "wb");
+    if (f == NULL)
+    {
+        perror(output);
+        return 1;
+    }
+
+    bool written = text ? write_text(f, &params) : write_binary(f, &params);
+    if (fclose(f) != 0 || !written)
+    {
+        perror(output);
+        return 1;
+    }
+    // #endregion WRITE_WORKLOAD
+
+    return 0;
+}
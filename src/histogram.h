@@ -0,0 +1,88 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Log-bucketed histogram of cycle counts, in the style of HdrHistogram, for percentiles in constant memory.
+ *
+ * Values below HISTOGRAM_EXACT get a bucket each. Above that, every power of two [2^e, 2^(e+1)) is split into
+ * HISTOGRAM_OCTAVE equal buckets, keeping the top HISTOGRAM_SUB_BITS bits of a value, so a bucket is never
+ * wider than 1/32 of its lowest value whatever the magnitude, and the whole uint32_t range fits in
+ * HISTOGRAM_BUCKETS counters. Recording is a count of leading zeros and an increment, and a percentile walks
+ * the buckets once. A zeroed histogram is empty.
+ */
+
+#define HISTOGRAM_SUB_BITS 6                          // Significant bits of a value kept by its bucket
+#define HISTOGRAM_EXACT (1u << HISTOGRAM_SUB_BITS)    // Values below this get a bucket each
+#define HISTOGRAM_OCTAVE (HISTOGRAM_EXACT / 2)        // Buckets per power of two above that
+#define HISTOGRAM_BUCKETS (HISTOGRAM_EXACT + (32 - HISTOGRAM_SUB_BITS) * HISTOGRAM_OCTAVE)
+
+typedef struct
+{
+    uint64_t count; // The number of values recorded
+    uint64_t sum;
+    uint32_t max; // The largest value recorded
+    uint32_t buckets[HISTOGRAM_BUCKETS];
+} histogram_t;
+
+/// @brief The bucket holding a value
+static inline uint32_t histogram_index(uint32_t v)
+{
+    if (v < HISTOGRAM_EXACT)
+    {
+        return v;
+    }
+    uint32_t shift = 31 - __builtin_clz(v) - (HISTOGRAM_SUB_BITS - 1);
+    return shift * HISTOGRAM_OCTAVE + (v >> shift);
+}
+
+/// @brief The highest value a bucket holds
+static inline uint32_t histogram_highest(uint32_t index)
+{
+    if (index < HISTOGRAM_EXACT)
+    {
+        return index;
+    }
+    uint32_t shift = index / HISTOGRAM_OCTAVE - 1;
+    uint32_t top = index % HISTOGRAM_OCTAVE + HISTOGRAM_OCTAVE;
+    return (uint32_t)((((uint64_t)top + 1) << shift) - 1);
+}
+
+static inline void histogram_record(histogram_t *h, uint32_t v)
+{
+    h->buckets[histogram_index(v)]++;
+    h->count++;
+    h->sum += v;
+    h->max = v > h->max ? v : h->max;
+}
+
+/// @brief The value at or below which a fraction q of the values lie, 0 < q <= 1, to within a bucket and never
+/// past the largest value. 0 when nothing was recorded.
+static inline uint32_t histogram_percentile(const histogram_t *h, double q)
+{
+    // The rank of the value, 1-based: the least whole number of values that is at least q of them
+    uint64_t rank = (uint64_t)(q * h->count);
+    rank += rank < q * h->count || rank == 0;
+
+    uint64_t seen = 0;
+    for (uint32_t k = 0; k < HISTOGRAM_BUCKETS; k++)
+    {
+        seen += h->buckets[k];
+        if (seen >= rank)
+        {
+            uint32_t highest = histogram_highest(k);
+            return highest < h->max ? highest : h->max;
+        }
+    }
+    return h->max;
+}
+
+/// @brief The mean of the values recorded, 0 when none were
+static inline double histogram_mean(const histogram_t *h)
+{
+    return h->count ? (double)h->sum / h->count : 0.0;
+}
+
+#endif // HISTOGRAM_H
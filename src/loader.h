@@ -0,0 +1,497 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "process.h"
+
+/*
+ * Loader for the input format: the number of processes N followed by N tuples (A B C M), (A B C M P),
+ * (A B C M P D) or (A B C M P D T), separated by any whitespace. Anything after the last tuple is ignored, such as the note at the end of
+ * sample_io/input/input-3.
+ *
+ * The file is mapped into memory and scanned once with a hand-rolled tokenizer, and the processes are
+ * stored on the heap, so inputs with millions of processes load quickly and do not depend on the stack size.
+ * Malformed input is reported with the line and column of the offending character.
+ *
+ * Inputs may also be in the binary workload format, recognised by its magic bytes: a workload_header_t
+ * followed by `count` packed records of `num_fields` little-endian unsigned fields (A B C M, then P when
+ * num_fields is 5, P D when it is 6 and P D T when it is 7), each `field_width` bytes wide. Records are decoded straight from the mapped file, with
+ * no parsing at all. The converter (src/convert_workload.c) turns text into binary and back.
+ */
+
+/* Where and why an input could not be loaded */
+typedef struct
+{
+    uint32_t line;   // 1-based, 0 when the error is not about a position in the file
+    uint32_t column; // 1-based
+    char message[96];
+} load_error_t;
+
+#define WORKLOAD_VERSION 1
+#define WORKLOAD_MAX_FIELDS 7 // A B C M P D T
+
+static const char WORKLOAD_MAGIC[4] = {'W', 'K', 'L', 'D'}; // Magic bytes of the binary workload format
+
+/* Header of the binary workload format, all fields little-endian */
+typedef struct
+{
+    char magic[4];       // WORKLOAD_MAGIC
+    uint32_t version;    // WORKLOAD_VERSION
+    uint32_t count;      // The number of records
+    uint8_t num_fields;  // 4 for (A B C M), 5 for (A B C M P), 6 for (A B C M P D), 7 for (A B C M P D T)
+    uint8_t field_width; // Bytes per field: 1, 2 or 4
+    uint8_t reserved[2]; // Zero
+} workload_header_t;
+
+/* Cursor over the input text */
+typedef struct
+{
+    const char *text;
+    size_t length;
+    size_t pos;
+} load_cursor_t;
+
+static inline bool load_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline void load_skip_space(load_cursor_t *cur)
+{
+    while (cur->pos < cur->length && load_is_space(cur->text[cur->pos]))
+    {
+        cur->pos++;
+    }
+}
+
+static inline bool load_at_digit(const load_cursor_t *cur)
+{
+    return cur->pos < cur->length && cur->text[cur->pos] >= '0' && cur->text[cur->pos] <= '9';
+}
+
+/// @brief Fills in an error at the current position of the cursor, counting lines up to it
+static inline bool load_fail(const load_cursor_t *cur, load_error_t *err, const char *message)
+{
+    err->line = 1;
+    err->column = 1;
+    for (size_t i = 0; i < cur->pos && i < cur->length; i++)
+    {
+        if (cur->text[i] == '\n')
+        {
+            err->line++;
+            err->column = 1;
+        }
+        else
+        {
+            err->column++;
+        }
+    }
+
+    snprintf(err->message, sizeof(err->message), "%s", message);
+    return false;
+}
+
+/// @brief Reads an unsigned 32 bit decimal number after optional whitespace
+static inline bool load_uint(load_cursor_t *cur, uint32_t *value, load_error_t *err, const char *what)
+{
+    load_skip_space(cur);
+    if (!load_at_digit(cur))
+    {
+        char message[sizeof(err->message)];
+        snprintf(message, sizeof(message), "expected %s", what);
+        return load_fail(cur, err, message);
+    }
+
+    size_t start = cur->pos;
+    uint64_t v = 0;
+    while (load_at_digit(cur))
+    {
+        v = v * 10 + (uint64_t)(cur->text[cur->pos] - '0');
+        if (v > UINT32_MAX)
+        {
+            cur->pos = start;
+            char message[sizeof(err->message)];
+            snprintf(message, sizeof(message), "%s does not fit in 32 bits", what);
+            return load_fail(cur, err, message);
+        }
+        cur->pos++;
+    }
+
+    *value = (uint32_t)v;
+    return true;
+}
+
+/// @brief Reads an unsigned 32 bit decimal number that must be at least 1, such as B which bounds a random CPU
+/// burst from 1 up, or M which makes an I/O burst at least as long as its CPU burst
+static inline bool load_positive(load_cursor_t *cur, uint32_t *value, load_error_t *err, const char *what)
+{
+    load_skip_space(cur);
+    size_t start = cur->pos;
+    if (!load_uint(cur, value, err, what))
+    {
+        return false;
+    }
+    if (*value == 0)
+    {
+        cur->pos = start;
+        char message[sizeof(err->message)];
+        snprintf(message, sizeof(message), "%s must be at least 1", what);
+        return load_fail(cur, err, message);
+    }
+    return true;
+}
+
+/// @brief Reads one character after optional whitespace
+static inline bool load_char(load_cursor_t *cur, char c, load_error_t *err, const char *message)
+{
+    load_skip_space(cur);
+    if (cur->pos >= cur->length || cur->text[cur->pos] != c)
+    {
+        return load_fail(cur, err, message);
+    }
+    cur->pos++;
+    return true;
+}
+
+/**
+ * Parses processes from text in the input format.
+ * On success *processes is a heap array of *total_num_of_process processes, to be released with free().
+ * Returns whether the text was valid, otherwise err says where it went wrong.
+ */
+static inline bool load_processes_text(const char *text, size_t length, process_t **processes, uint32_t *total_num_of_process, load_error_t *err)
+{
+    load_cursor_t cur = {.text = text, .length = length};
+    *processes = NULL;
+    *total_num_of_process = 0;
+
+    uint32_t n;
+    if (!load_uint(&cur, &n, err, "the number of processes"))
+    {
+        return false;
+    }
+
+    // The shortest tuple, (0 1 0 1), takes 9 characters, so a count past what the rest of the text can hold
+    // fails on a missing tuple before filling this many
+    size_t capacity = (length - cur.pos) / 9 + 1;
+    capacity = n < capacity ? n : capacity;
+
+    process_t *list = malloc(sizeof(process_t) * (capacity ? capacity : 1));
+    for (uint32_t i = 0; i < n; i++)
+    {
+        process_t *p = &list[i];
+        *p = (process_t){.id = i};
+
+        if (!load_char(&cur, '(', err, "expected '(' to start a process") ||
+            !load_uint(&cur, &p->A, err, "the arrival time A") ||
+            !load_positive(&cur, &p->B, err, "the CPU burst bound B") ||
+            !load_uint(&cur, &p->C, err, "the total CPU time C") ||
+            !load_positive(&cur, &p->M, err, "the I/O multiplier M"))
+        {
+            free(list);
+            return false;
+        }
+
+        // Optional fifth, sixth and seventh fields
+        load_skip_space(&cur);
+        if (load_at_digit(&cur) && !load_uint(&cur, &p->priority, err, "the priority P"))
+        {
+            free(list);
+            return false;
+        }
+        load_skip_space(&cur);
+        if (load_at_digit(&cur) && !load_uint(&cur, &p->deadline, err, "the deadline D"))
+        {
+            free(list);
+            return false;
+        }
+        load_skip_space(&cur);
+        if (load_at_digit(&cur) && !load_uint(&cur, &p->tickets, err, "the tickets T"))
+        {
+            free(list);
+            return false;
+        }
+
+        if (!load_char(&cur, ')', err, "expected ')' to end a process"))
+        {
+            free(list);
+            return false;
+        }
+    }
+
+    *processes = list;
+    *total_num_of_process = n;
+    return true;
+}
+
+static inline uint32_t load_le(const uint8_t *bytes, uint32_t width)
+{
+    uint32_t v = 0;
+    for (uint32_t b = 0; b < width; b++)
+    {
+        v |= (uint32_t)bytes[b] << (8 * b);
+    }
+    return v;
+}
+
+static inline void store_le(uint8_t *bytes, uint32_t v, uint32_t width)
+{
+    for (uint32_t b = 0; b < width; b++)
+    {
+        bytes[b] = (uint8_t)(v >> (8 * b));
+    }
+}
+
+/// @brief Whether data starts with the magic bytes of the binary workload format
+static inline bool load_is_binary(const void *data, size_t length)
+{
+    return length >= sizeof(WORKLOAD_MAGIC) && memcmp(data, WORKLOAD_MAGIC, sizeof(WORKLOAD_MAGIC)) == 0;
+}
+
+/**
+ * Decodes processes from data in the binary workload format.
+ * On success *processes is a heap array of *total_num_of_process processes, to be released with free().
+ * Returns whether the data was valid, otherwise err says why.
+ */
+static inline bool load_processes_binary(const void *data, size_t length, process_t **processes, uint32_t *total_num_of_process, load_error_t *err)
+{
+    const uint8_t *bytes = data;
+    *processes = NULL;
+    *total_num_of_process = 0;
+    *err = (load_error_t){0};
+
+    if (length < sizeof(workload_header_t) || !load_is_binary(data, length))
+    {
+        snprintf(err->message, sizeof(err->message), "Not a binary workload.");
+        return false;
+    }
+
+    uint32_t version = load_le(bytes + offsetof(workload_header_t, version), 4);
+    uint32_t count = load_le(bytes + offsetof(workload_header_t, count), 4);
+    uint32_t num_fields = bytes[offsetof(workload_header_t, num_fields)];
+    uint32_t width = bytes[offsetof(workload_header_t, field_width)];
+
+    if (version != WORKLOAD_VERSION)
+    {
+        snprintf(err->message, sizeof(err->message), "Unsupported binary workload version %u.", version);
+        return false;
+    }
+    if (num_fields < 4 || num_fields > WORKLOAD_MAX_FIELDS || (width != 1 && width != 2 && width != 4))
+    {
+        snprintf(err->message, sizeof(err->message), "Unsupported binary workload layout of %u fields of %u bytes.", num_fields, width);
+        return false;
+    }
+
+    size_t record_size = (size_t)num_fields * width;
+    if (length - sizeof(workload_header_t) != (size_t)count * record_size)
+    {
+        snprintf(err->message, sizeof(err->message), "The binary workload should hold %u records.", count);
+        return false;
+    }
+
+    process_t *list = malloc(sizeof(process_t) * (count ? count : 1));
+    const uint8_t *record = bytes + sizeof(workload_header_t);
+    for (uint32_t i = 0; i < count; i++, record += record_size)
+    {
+        list[i] = (process_t){
+            .A = load_le(record, width),
+            .B = load_le(record + width, width),
+            .C = load_le(record + 2 * width, width),
+            .M = load_le(record + 3 * width, width),
+            .priority = num_fields >= 5 ? load_le(record + 4 * width, width) : 0,
+            .deadline = num_fields >= 6 ? load_le(record + 5 * width, width) : 0,
+            .tickets = num_fields >= 7 ? load_le(record + 6 * width, width) : 0,
+            .id = i,
+        };
+
+        if (list[i].B == 0)
+        {
+            snprintf(err->message, sizeof(err->message), "The CPU burst bound B of process %u must be at least 1.", i);
+            free(list);
+            return false;
+        }
+        if (list[i].M == 0)
+        {
+            snprintf(err->message, sizeof(err->message), "The I/O multiplier M of process %u must be at least 1.", i);
+            free(list);
+            return false;
+        }
+    }
+
+    *processes = list;
+    *total_num_of_process = count;
+    return true;
+}
+
+/// @brief The narrowest field width of the binary workload format that holds values up to max
+static inline uint32_t workload_field_width(uint32_t max)
+{
+    return max <= UINT8_MAX ? 1 : max <= UINT16_MAX ? 2 : 4;
+}
+
+/// @brief Writes the header of a binary workload of `count` records
+static inline bool save_workload_header(FILE *f, uint32_t count, uint32_t num_fields, uint32_t width)
+{
+    uint8_t header[sizeof(workload_header_t)] = {0};
+    memcpy(header, WORKLOAD_MAGIC, sizeof(WORKLOAD_MAGIC));
+    store_le(header + offsetof(workload_header_t, version), WORKLOAD_VERSION, 4);
+    store_le(header + offsetof(workload_header_t, count), count, 4);
+    header[offsetof(workload_header_t, num_fields)] = num_fields;
+    header[offsetof(workload_header_t, field_width)] = width;
+    return fwrite(header, sizeof(header), 1, f) == 1;
+}
+
+/// @brief The fields a workload needs: 7 if a process has tickets, else 6 if one has a deadline, else 5 if one
+/// has a priority, else 4
+static inline uint32_t workload_num_fields(uint32_t num_fields, const process_t *p)
+{
+    uint32_t needed = p->tickets ? 7 : p->deadline ? 6 : p->priority ? 5 : 4;
+    return needed > num_fields ? needed : num_fields;
+}
+
+/// @brief Writes one record of a binary workload, the values A B C M P D T must fit in the field width
+static inline bool save_workload_record(FILE *f, const uint32_t values[WORKLOAD_MAX_FIELDS], uint32_t num_fields,
+                                        uint32_t width)
+{
+    uint8_t record[WORKLOAD_MAX_FIELDS * 4];
+    for (uint32_t k = 0; k < num_fields; k++)
+    {
+        store_le(record + k * width, values[k], width);
+    }
+    return fwrite(record, width, num_fields, f) == num_fields;
+}
+
+/**
+ * Writes processes in the binary workload format, with the narrowest field width that holds every value.
+ * Each optional field is only stored when a process has it or a later field.
+ * Returns whether the file could be written.
+ */
+static inline bool save_processes_binary(const char *file_name, const process_t *processes,
+                                         uint32_t total_num_of_process)
+{
+    uint32_t max = 0;
+    uint32_t num_fields = 4;
+    for (uint32_t i = 0; i < total_num_of_process; i++)
+    {
+        const process_t *p = &processes[i];
+        uint32_t values[WORKLOAD_MAX_FIELDS] = {p->A, p->B, p->C, p->M, p->priority, p->deadline, p->tickets};
+        for (uint32_t k = 0; k < WORKLOAD_MAX_FIELDS; k++)
+        {
+            max = values[k] > max ? values[k] : max;
+        }
+        num_fields = workload_num_fields(num_fields, p);
+    }
+    uint32_t width = workload_field_width(max);
+
+    FILE *f = fopen(file_name, "wb");
+    if (f == NULL)
+    {
+        return false;
+    }
+
+    bool written = save_workload_header(f, total_num_of_process, num_fields, width);
+    for (uint32_t i = 0; written && i < total_num_of_process; i++)
+    {
+        const process_t *p = &processes[i];
+        uint32_t values[WORKLOAD_MAX_FIELDS] = {p->A, p->B, p->C, p->M, p->priority, p->deadline, p->tickets};
+        written = save_workload_record(f, values, num_fields, width);
+    }
+
+    return fclose(f) == 0 && written;
+}
+
+/**
+ * Writes processes in the text format, one tuple per line. Each optional field is only written when a process
+ * has it or a later field.
+ * Returns whether the file could be written.
+ */
+static inline bool save_processes_text(const char *file_name, const process_t *processes, uint32_t total_num_of_process)
+{
+    FILE *f = fopen(file_name, "w");
+    if (f == NULL)
+    {
+        return false;
+    }
+
+    uint32_t num_fields = 4;
+    for (uint32_t i = 0; i < total_num_of_process; i++)
+    {
+        num_fields = workload_num_fields(num_fields, &processes[i]);
+    }
+
+    fprintf(f, "%u\n", total_num_of_process);
+    for (uint32_t i = 0; i < total_num_of_process; i++)
+    {
+        const process_t *p = &processes[i];
+        uint32_t values[WORKLOAD_MAX_FIELDS] = {p->A, p->B, p->C, p->M, p->priority, p->deadline, p->tickets};
+        for (uint32_t k = 0; k < num_fields; k++)
+        {
+            fprintf(f, k ? " %u" : "(%u", values[k]);
+        }
+        fprintf(f, ")\n");
+    }
+
+    bool written = !ferror(f);
+    return fclose(f) == 0 && written;
+}
+
+/**
+ * Loads the processes of an input file in the text or the binary format, see load_processes_text() and
+ * load_processes_binary().
+ * Returns whether the file could be read and was valid, otherwise err says why.
+ */
+static inline bool load_processes_file(const char *file_name, process_t **processes, uint32_t *total_num_of_process, load_error_t *err)
+{
+    *err = (load_error_t){0};
+
+    int fd = open(file_name, O_RDONLY);
+    if (fd < 0)
+    {
+        snprintf(err->message, sizeof(err->message), "Failed to open the file.");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        snprintf(err->message, sizeof(err->message), "Failed to open the file.");
+        return false;
+    }
+
+    // An empty file cannot be mapped, it parses as empty text
+    size_t length = (size_t)st.st_size;
+    const char *text = "";
+    if (length > 0)
+    {
+        text = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (text == MAP_FAILED)
+        {
+            close(fd);
+            snprintf(err->message, sizeof(err->message), "Failed to read the file.");
+            return false;
+        }
+        madvise((void *)text, length, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    bool loaded = load_is_binary(text, length)
+                      ? load_processes_binary(text, length, processes, total_num_of_process, err)
+                      : load_processes_text(text, length, processes, total_num_of_process, err);
+
+    if (length > 0)
+    {
+        munmap((void *)text, length);
+    }
+    return loaded;
+}
+
+#endif // LOADER_H
@@ -0,0 +1,297 @@
+#ifndef MULTICORE_H
+#define MULTICORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "scheduler.h"
+#include "event.h"
+
+/*
+ * Multi-core versions of fcfs(), sjf() and rr(), simulating K cores that each run one process at a time.
+ *
+ * Every core has its own run queue. The cycle goes through the phases of scheduler.h:
+ *   1. arriving processes are queued on the core with the least work (queued plus running)
+ *   2. the sweep, after which woken processes are queued back on the core they last ran on
+ *   3. every core runs its process for the cycle. Under preemptive RR a process that used up its quantum goes
+ *      back to the run queue of its core, if anything else is queued there
+ *   4. every free core dispatches from its own run queue, then every core still free steals the next
+ *      process of the longest run queue. A stolen process migrates to the thief.
+ *
+ * With one core FCFS and RR give the same results as fcfs() and rr(). SJF runs a single process per
+ * core, whereas sjf() dispatches the shortest READY process every cycle even while another one runs.
+ */
+
+/* A simulated core and its run queue */
+typedef struct
+{
+    ready_set_t fifo;       // FCFS, RR: queued processes, picked circularly by index like the single-core scan
+    ready_queue_t shortest; // SJF: queued processes by remaining CPU time, only allocated for SJF
+    uint32_t running;       // The running process, or NO_PROCESS
+    uint32_t scan_from;     // Where the circular pick starts, after the process that just left the core
+} core_t;
+
+static inline uint32_t core_queued(const core_t *c, event_policy policy)
+{
+    return policy == POLICY_SJF ? c->shortest.size : c->fifo.size;
+}
+
+/// @brief Queues a READY process on a core
+static inline void core_enqueue(core_t *c, event_policy policy, const process_table_t *t, uint32_t i)
+{
+    if (policy == POLICY_SJF)
+    {
+        ready_queue_push(&c->shortest, i, t->C[i] - t->cpu_time[i]);
+    }
+    else
+    {
+        ready_set_add(&c->fifo, i);
+    }
+}
+
+/// @brief Removes the process a core runs next from its run queue, which must not be empty
+/// @param from where the circular pick of FCFS and RR starts
+static inline uint32_t core_dequeue(core_t *c, event_policy policy, uint32_t from)
+{
+    if (policy == POLICY_SJF)
+    {
+        return ready_queue_pop(&c->shortest);
+    }
+
+    uint32_t i = ready_set_next(&c->fifo, from < c->fifo.num_words * 64 ? from : 0);
+    ready_set_remove(&c->fifo, i);
+    return i;
+}
+
+/// @brief The core with the least queued and running work, the lowest one on a tie
+static inline uint32_t multicore_least_loaded(const core_t *cores, uint32_t num_cores, event_policy policy)
+{
+    uint32_t best = 0;
+    uint32_t best_load = UINT32_MAX;
+    for (uint32_t c = 0; c < num_cores; c++)
+    {
+        uint32_t load = core_queued(&cores[c], policy) + (cores[c].running != NO_PROCESS);
+        if (load < best_load)
+        {
+            best = c;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+/// @brief The core with the longest run queue, the lowest one on a tie
+/// @return the core, or NO_PROCESS if every run queue is empty
+static inline uint32_t multicore_longest_queue(const core_t *cores, uint32_t num_cores, event_policy policy)
+{
+    uint32_t best = NO_PROCESS;
+    uint32_t best_queued = 0;
+    for (uint32_t c = 0; c < num_cores; c++)
+    {
+        if (core_queued(&cores[c], policy) > best_queued)
+        {
+            best = c;
+            best_queued = core_queued(&cores[c], policy);
+        }
+    }
+    return best;
+}
+
+/// @brief Ready -> Running, a process preempted by RR resumes its CPU burst instead of drawing a new one
+static inline void multicore_dispatch(process_table_t *t, uint32_t i, uint8_t quantum)
+{
+    process_table_dispatch(t, i, t->cpu_burst[i] == 0);
+    t->quantum[i] = quantum;
+}
+
+/// @brief Multi-core scheduler, see the top of this file
+/// @param quantum the time quantum, only used by POLICY_RR_PREEMPTIVE
+/// @param num_cores the number of cores, 1 .. MAX_CORES
+static inline scheduler_result_t multicore_schedule(const sched_context_t *context, process_t *processes,
+                                                    uint32_t total_num_of_process, event_policy policy, uint8_t quantum,
+                                                    uint32_t num_cores)
+{
+    assert(num_cores >= 1 && num_cores <= MAX_CORES);
+
+    qsort(processes, total_num_of_process, sizeof(process_t), cmpr_process_a);
+
+    const sched_allocator_t *allocator = &context->allocator;
+    process_table_t t;
+    process_table_init(&t, processes, total_num_of_process, context);
+
+    scheduler_result_t r = {.num_cores = num_cores}; // Result of the scheduler
+    uint32_t next_arrival = 0;                       // First process that has not arrived yet
+
+    core_t cores[MAX_CORES];
+    for (uint32_t c = 0; c < num_cores; c++)
+    {
+        cores[c] = (core_t){.running = NO_PROCESS};
+        ready_set_init(&cores[c].fifo, total_num_of_process, allocator);
+        if (policy == POLICY_SJF)
+        {
+            ready_queue_init(&cores[c].shortest, total_num_of_process, allocator);
+        }
+    }
+
+    // The core each process was queued on or last ran on
+    uint32_t *last_core = sched_malloc(allocator, total_num_of_process, sizeof(uint32_t));
+
+    PROFILE_CLOCK(start);
+    PROFILE_CLOCK(lap);
+    while (r.total_finished_processes < total_num_of_process)
+    {
+        // Unstarted -> Ready, on the core with the least work
+        uint32_t arrived = process_table_arrive(&t, next_arrival, r.current_cycle);
+        r.total_created_processes += arrived - next_arrival;
+        for (; next_arrival < arrived; next_arrival++)
+        {
+            last_core[next_arrival] = multicore_least_loaded(cores, num_cores, policy);
+            core_enqueue(&cores[last_core[next_arrival]], policy, &t, next_arrival);
+            PROFILE_ADD(&r, enqueues, 1);
+        }
+        PROFILE_LAP(&r, PHASE_ARRIVE, lap);
+
+        // Blocked -> Ready, back on the core the process last ran on
+        r.total_number_of_cycles_spent_blocked += process_table_sweep(&t);
+        for (uint32_t i = process_table_next_woken(&t, 0); i != NO_PROCESS; i = process_table_next_woken(&t, i + 1))
+        {
+            core_enqueue(&cores[last_core[i]], policy, &t, i);
+            PROFILE_ADD(&r, enqueues, 1);
+        }
+        PROFILE_LAP(&r, PHASE_SWEEP, lap);
+
+        // Running -> Terminate or Block
+        bool idle = true;
+        for (uint32_t c = 0; c < num_cores; c++)
+        {
+            core_t *core = &cores[c];
+            core->scan_from = 0;
+            if (core->running == NO_PROCESS)
+            {
+                continue;
+            }
+
+            r.core_busy_cycles[c]++;
+            idle = false;
+
+            bool left = process_table_run(&t, core->running, &r);
+
+            // RR: Running -> Blocked after every cycle, for the I/O of the whole burst
+            if (!left && policy == POLICY_RR)
+            {
+                t.cpu_burst[core->running] = 0;
+                t.status[core->running] = BLOCKED;
+                left = true;
+            }
+
+            if (left)
+            {
+                core->scan_from = core->running + 1;
+                core->running = NO_PROCESS;
+            }
+
+            // Preemptive RR: Running -> Ready once the quantum is used up, unless nothing else is queued on the core
+            else if (policy == POLICY_RR_PREEMPTIVE && --t.quantum[core->running] == 0)
+            {
+                if (core_queued(core, policy))
+                {
+                    t.status[core->running] = READY;
+                    core_enqueue(core, policy, &t, core->running);
+                    PROFILE_ADD(&r, enqueues, 1);
+                    r.total_preemptions++;
+                    core->scan_from = core->running + 1;
+                    core->running = NO_PROCESS;
+                }
+                else
+                {
+                    t.quantum[core->running] = quantum;
+                }
+            }
+        }
+
+        PROFILE_ADD(&r, idle_cycles, idle);
+        PROFILE_LAP(&r, PHASE_RUN, lap);
+
+        // Ready -> Running from the core's own run queue
+        for (uint32_t c = 0; c < num_cores; c++)
+        {
+            core_t *core = &cores[c];
+            if (core->running == NO_PROCESS && core_queued(core, policy))
+            {
+                core->running = core_dequeue(core, policy, core->scan_from);
+                PROFILE_ADD(&r, picks, 1);
+                PROFILE_ADD(&r, burst_draws, t.cpu_burst[core->running] == 0);
+                multicore_dispatch(&t, core->running, quantum);
+                r.total_context_switches++;
+            }
+        }
+
+        // Ready -> Running on an idle core, stolen from the longest run queue
+        for (uint32_t c = 0; c < num_cores; c++)
+        {
+            if (cores[c].running != NO_PROCESS)
+            {
+                continue;
+            }
+
+            uint32_t victim = multicore_longest_queue(cores, num_cores, policy);
+            if (victim == NO_PROCESS)
+            {
+                break;
+            }
+
+            uint32_t i = core_dequeue(&cores[victim], policy, 0);
+            PROFILE_ADD(&r, picks, 1);
+            PROFILE_ADD(&r, burst_draws, t.cpu_burst[i] == 0);
+            cores[c].running = i;
+            last_core[i] = c;
+            multicore_dispatch(&t, i, quantum);
+            r.total_context_switches++;
+
+            r.core_migrations[c]++;
+            r.total_migrations++;
+        }
+        PROFILE_LAP(&r, PHASE_PICK, lap);
+
+        r.current_cycle++;
+    }
+    PROFILE_TOTAL(&r, start);
+
+    process_table_store(&t, processes);
+    process_table_free(&t);
+    for (uint32_t c = 0; c < num_cores; c++)
+    {
+        ready_set_free(&cores[c].fifo);
+        ready_queue_free(&cores[c].shortest);
+    }
+    sched_free(allocator, last_core);
+    return r;
+}
+
+/// @brief Multi-core First-Come-First-Serve (FCFS) Scheduler, see fcfs()
+static inline scheduler_result_t fcfs_multicore(const sched_context_t *context, process_t *processes,
+                                                uint32_t total_num_of_process, uint32_t num_cores)
+{
+    return multicore_schedule(context, processes, total_num_of_process, POLICY_FCFS, 0, num_cores);
+}
+
+/// @brief Multi-core Shortest Job First (SJF) Scheduler, see sjf()
+static inline scheduler_result_t sjf_multicore(const sched_context_t *context, process_t *processes,
+                                               uint32_t total_num_of_process, uint32_t num_cores)
+{
+    return multicore_schedule(context, processes, total_num_of_process, POLICY_SJF, 0, num_cores);
+}
+
+/// @brief Multi-core Round Robin (RR) Scheduler, see rr()
+/// @param quantum the time quantum for the scheduler
+/// @param preemptive whether to preempt at the end of the quantum rather than block after every cycle
+static inline scheduler_result_t rr_multicore(const sched_context_t *context, process_t *processes,
+                                              uint32_t total_num_of_process,
+                                              uint8_t quantum, bool preemptive, uint32_t num_cores)
+{
+    event_policy policy = preemptive ? POLICY_RR_PREEMPTIVE : POLICY_RR;
+    return multicore_schedule(context, processes, total_num_of_process, policy, quantum, num_cores);
+}
+
+#endif // MULTICORE_H
@@ -0,0 +1,106 @@
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "histogram.h"
+#include "profile.h"
+
+typedef enum
+{
+    UNSTARTED = 0,
+    READY = 1,
+    RUNNING = 2,
+    BLOCKED = 3,
+    TERMINATED = 4
+} process_status;
+
+/* Defines a job struct */
+typedef struct _process
+{
+    uint32_t A;  // A: Arrival time of the process
+    uint32_t B;  // B: Upper Bound of CPU burst times of the given random integer list
+    uint32_t C;  // C: Total CPU time required
+    uint32_t M;  // M: Multiplier of CPU burst time
+    uint32_t id; // The process ID given upon input read
+
+    uint8_t status; // 0 is unstarted, 1 is ready, 2 is running, 3 is blocked, 4 is terminated
+
+    int32_t finished_time; // The cycle when the the process finishes (initially -1)
+    uint32_t cpu_time;     // The amount of time the process has already run (time in running state)
+    uint32_t blocked_time; // The amount of time the process has been IO blocked (time in blocked state)
+    uint32_t waiting_time; // The amount of time spent waiting to be run (time in ready state)
+
+    uint32_t io_burst;  // The amount of time until the process finishes being blocked
+    uint32_t cpu_burst; // The CPU availability of the process (has to be > 1 to move to running)
+
+    int32_t quantum; // Used for schedulers that utilise pre-emption
+
+    bool is_first_run; // Used to check when to calculate the CPU burst when it hits running mode
+
+    uint32_t priority;           // P: Priority of the process, lower runs first (optional fifth input field, 0 if omitted)
+    uint32_t deadline;           // D: Cycles after its arrival the process should finish by (optional sixth input field, 0 for none)
+    uint32_t tickets;            // T: Lottery tickets of the process (optional seventh input field, 0 for the default share)
+    double entitled_time;        // Proportional share schedulers only: the CPU time its tickets entitled the process to
+    uint32_t effective_priority; // The priority after aging, reset to P whenever the process is dispatched
+} process_t;
+
+static inline int cmpr_process_a(const void *a, const void *b)
+{
+    process_t *pa = (process_t *)a;
+    process_t *pb = (process_t *)b;
+
+    return (pa->A > pb->A) - (pa->A < pb->A);
+}
+
+#define MAX_CORES 64  // The most cores a multi-core scheduler can simulate
+#define MAX_LEVELS 16 // The most levels of the multi-level feedback queue scheduler
+
+typedef struct
+{
+    uint32_t current_cycle;                        // The current cycle that each process is on
+    uint32_t total_created_processes;              // The total number of processes constructed
+    uint32_t total_started_processes;              // The total number of processes that have started being simulated
+    uint32_t total_finished_processes;             // The total number of processes that have finished running
+    uint32_t total_number_of_cycles_spent_blocked; // The total cycles in the blocked state
+    uint32_t total_context_switches;               // The times a process was dispatched onto a CPU
+    uint32_t total_preemptions;                    // The times a RUNNING process went back to READY mid-burst
+
+    // Multi-core schedulers only, see multicore.h
+    uint32_t num_cores;                   // The number of cores simulated, 0 for the single-core schedulers
+    uint32_t core_busy_cycles[MAX_CORES]; // The cycles each core spent running a process
+    uint32_t core_migrations[MAX_CORES];  // The processes each core stole from the run queue of another core
+    uint32_t total_migrations;            // The sum of core_migrations
+
+    // Multi-level feedback queue scheduler only, see mlfq()
+    uint32_t num_levels;               // The number of levels, 0 for the other schedulers
+    uint32_t level_cycles[MAX_LEVELS]; // The cycles processes ran for at each level
+
+    // Latency distributions, recorded as each process first runs and as it terminates
+    histogram_t turnaround_times; // Finishing time minus arrival time
+    histogram_t waiting_times;    // Cycles spent READY
+    histogram_t response_times;   // The first cycle run minus arrival time
+    histogram_t io_times;         // Cycles spent BLOCKED
+
+#ifdef SCHED_PROFILE
+    profile_t profile; // Instrumentation of the run, see profile.h
+#endif
+} scheduler_result_t;
+
+/// @brief Records the response time of a process on the first cycle it runs: the cycle it was dispatched on,
+/// the one before, minus its arrival. Like the waiting time it is 0 for a process dispatched as it arrives.
+static inline void record_first_run(scheduler_result_t *r, uint32_t dispatch, uint32_t arrival)
+{
+    histogram_record(&r->response_times, dispatch - arrival);
+}
+
+/// @brief Records the latencies of a process as it terminates
+static inline void record_termination(scheduler_result_t *r, uint32_t turnaround, uint32_t waiting, uint32_t io)
+{
+    histogram_record(&r->turnaround_times, turnaround);
+    histogram_record(&r->waiting_times, waiting);
+    histogram_record(&r->io_times, io);
+}
+
+#endif // PROCESS_H
@@ -0,0 +1,292 @@
+#ifndef PROCESS_TABLE_H
+#define PROCESS_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "process.h"
+#include "context.h"
+
+/*
+ * Structure-of-arrays layout of a process array, used by the tick schedulers.
+ *
+ * Every cycle touches the status and counters of every process but almost never the input fields, so
+ * each field gets its own packed array. A sweep over status/io_burst/blocked_time/waiting_time then
+ * streams through a few cache lines instead of a whole process_t per process, and runs as SIMD.
+ */
+
+#define NO_PROCESS UINT32_MAX // Index used when no process is selected
+#define PROCESS_TABLE_ALIGN 64 // Alignment of every array, one cache line
+
+typedef struct
+{
+    uint32_t size; // The number of processes
+
+    // Input, read rarely
+    uint32_t *A;
+    uint32_t *B;
+    uint32_t *C;
+    uint32_t *M;
+    uint32_t *id;
+    uint32_t *priority;
+    uint32_t *deadline;
+    uint32_t *tickets;
+
+    // State, read or written every cycle
+    uint8_t *status;
+    uint32_t *io_burst;
+    uint32_t *cpu_burst;
+    uint32_t *cpu_time;
+    uint32_t *blocked_time;
+    uint32_t *waiting_time;
+    int32_t *finished_time;
+    uint8_t *is_first_run;
+    uint32_t *effective_priority;
+    uint32_t *quantum; // Cycles left in the time slice of a RUNNING process (RR)
+    uint64_t *woken; // Bit i is set when process i became READY in the last sweep
+
+    sweep_kernel_fn sweep;          // The sweep kernel of the context for this CPU, see sweep.h
+    const sched_context_t *context; // Where the bursts are drawn from and the arrays come from
+} process_table_t;
+
+/// @brief Allocates a zeroed array of n elements aligned to a cache line
+static inline void *process_table_array(const process_table_t *t, uint32_t n, size_t element_size)
+{
+    size_t bytes = (size_t)(n ? n : 1) * element_size;
+    bytes = (bytes + PROCESS_TABLE_ALIGN - 1) / PROCESS_TABLE_ALIGN * PROCESS_TABLE_ALIGN;
+
+    void *array = sched_aligned_alloc(&t->context->allocator, bytes, PROCESS_TABLE_ALIGN);
+    memset(array, 0, bytes);
+    return array;
+}
+
+/// @brief Builds a process table from a process array, for runs in the given context
+static inline void process_table_init(process_table_t *t, const process_t *processes, uint32_t total_num_of_process,
+                                      const sched_context_t *context)
+{
+    uint32_t n = total_num_of_process;
+    t->size = n;
+    t->context = context;
+
+    t->A = process_table_array(t, n, sizeof(uint32_t));
+    t->B = process_table_array(t, n, sizeof(uint32_t));
+    t->C = process_table_array(t, n, sizeof(uint32_t));
+    t->M = process_table_array(t, n, sizeof(uint32_t));
+    t->id = process_table_array(t, n, sizeof(uint32_t));
+    t->priority = process_table_array(t, n, sizeof(uint32_t));
+    t->deadline = process_table_array(t, n, sizeof(uint32_t));
+    t->tickets = process_table_array(t, n, sizeof(uint32_t));
+
+    t->status = process_table_array(t, n, sizeof(uint8_t));
+    t->io_burst = process_table_array(t, n, sizeof(uint32_t));
+    t->cpu_burst = process_table_array(t, n, sizeof(uint32_t));
+    t->cpu_time = process_table_array(t, n, sizeof(uint32_t));
+    t->blocked_time = process_table_array(t, n, sizeof(uint32_t));
+    t->waiting_time = process_table_array(t, n, sizeof(uint32_t));
+    t->finished_time = process_table_array(t, n, sizeof(int32_t));
+    t->is_first_run = process_table_array(t, n, sizeof(uint8_t));
+    t->effective_priority = process_table_array(t, n, sizeof(uint32_t));
+    t->quantum = process_table_array(t, n, sizeof(uint32_t));
+    t->woken = process_table_array(t, (n + 63) / 64, sizeof(uint64_t));
+    t->sweep = sweep_kernel_select(context->sweep);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        const process_t *p = &processes[i];
+
+        t->A[i] = p->A;
+        t->B[i] = p->B;
+        t->C[i] = p->C;
+        t->M[i] = p->M;
+        t->id[i] = p->id;
+        t->priority[i] = p->priority;
+        t->deadline[i] = p->deadline;
+        t->tickets[i] = p->tickets;
+
+        t->status[i] = p->status;
+        t->io_burst[i] = p->io_burst;
+        t->cpu_burst[i] = p->cpu_burst;
+        t->cpu_time[i] = p->cpu_time;
+        t->blocked_time[i] = p->blocked_time;
+        t->waiting_time[i] = p->waiting_time;
+        t->finished_time[i] = p->finished_time;
+        t->is_first_run[i] = p->is_first_run;
+        t->effective_priority[i] = p->effective_priority;
+        t->quantum[i] = p->quantum;
+    }
+}
+
+/// @brief Writes the state of a process table back to the process array it was built from
+static inline void process_table_store(const process_table_t *t, process_t *processes)
+{
+    for (uint32_t i = 0; i < t->size; i++)
+    {
+        process_t *p = &processes[i];
+
+        p->status = t->status[i];
+        p->io_burst = t->io_burst[i];
+        p->cpu_burst = t->cpu_burst[i];
+        p->cpu_time = t->cpu_time[i];
+        p->blocked_time = t->blocked_time[i];
+        p->waiting_time = t->waiting_time[i];
+        p->finished_time = t->finished_time[i];
+        p->is_first_run = t->is_first_run[i];
+        p->effective_priority = t->effective_priority[i];
+        p->quantum = t->quantum[i];
+    }
+}
+
+static inline void process_table_free(process_table_t *t)
+{
+    const sched_allocator_t *allocator = &t->context->allocator;
+
+    sched_free(allocator, t->A);
+    sched_free(allocator, t->B);
+    sched_free(allocator, t->C);
+    sched_free(allocator, t->M);
+    sched_free(allocator, t->id);
+    sched_free(allocator, t->priority);
+    sched_free(allocator, t->deadline);
+    sched_free(allocator, t->tickets);
+
+    sched_free(allocator, t->status);
+    sched_free(allocator, t->io_burst);
+    sched_free(allocator, t->cpu_burst);
+    sched_free(allocator, t->cpu_time);
+    sched_free(allocator, t->blocked_time);
+    sched_free(allocator, t->waiting_time);
+    sched_free(allocator, t->finished_time);
+    sched_free(allocator, t->is_first_run);
+    sched_free(allocator, t->effective_priority);
+    sched_free(allocator, t->quantum);
+    sched_free(allocator, t->woken);
+
+    *t = (process_table_t){0};
+}
+
+/// @brief Calculates the CPU burst time and the IO burst time for a given process, see set_bursts()
+static inline void process_table_set_bursts(process_table_t *t, uint32_t i)
+{
+    t->cpu_burst[i] = randomOS(t->context->random, t->B[i], t->id[i]);
+    t->io_burst[i] = t->cpu_burst[i] * t->M[i];
+}
+
+/// @brief Unstarted -> Ready for every process arriving this cycle
+///
+/// The table must be sorted by arrival time, next_arrival is the index of the first unstarted process.
+/// @return the index one past the last process that arrived
+static inline uint32_t process_table_arrive(process_table_t *t, uint32_t next_arrival, uint32_t cycle)
+{
+    for (; next_arrival < t->size && t->A[next_arrival] == cycle; next_arrival++)
+    {
+        uint32_t i = next_arrival;
+
+        t->cpu_time[i] = 0;
+        t->blocked_time[i] = 0;
+        t->waiting_time[i] = 0;
+        t->is_first_run[i] = true;
+        t->cpu_burst[i] = 0;
+        t->effective_priority[i] = t->priority[i];
+
+        t->status[i] = READY;
+    }
+    return next_arrival;
+}
+
+/// @brief Blocked -> Ready once the I/O burst is over, then counts a cycle of waiting for every READY process
+///
+/// Runs the SIMD sweep kernel picked for this CPU. The processes that became READY are flagged in t->woken.
+/// @return the number of processes that were BLOCKED this cycle
+static inline uint32_t process_table_sweep(process_table_t *t)
+{
+    return t->sweep(t->status, t->io_burst, t->blocked_time, t->waiting_time, t->woken, t->size);
+}
+
+/// @brief Finds the next process flagged as woken by the last sweep, at or after index `from`
+/// @return the index of the process, or NO_PROCESS if there is none
+static inline uint32_t process_table_next_woken(const process_table_t *t, uint32_t from)
+{
+    uint32_t num_words = (t->size + 63) / 64;
+    uint32_t w = from / 64;
+    if (w >= num_words)
+    {
+        return NO_PROCESS;
+    }
+
+    uint64_t bits = t->woken[w] & (~0ull << (from % 64));
+    while (!bits && ++w < num_words)
+    {
+        bits = t->woken[w];
+    }
+    return bits ? w * 64 + __builtin_ctzll(bits) : NO_PROCESS;
+}
+
+/// @brief Runs a RUNNING process for one cycle.
+///
+/// Running -> Terminated once C is reached, Running -> Blocked once the CPU burst is used up.
+/// @return whether the process left the CPU
+static inline bool process_table_run(process_table_t *t, uint32_t i, scheduler_result_t *r)
+{
+    t->cpu_time[i]++;
+    t->cpu_burst[i]--;
+    if (t->is_first_run[i])
+    {
+        r->total_started_processes++;
+        record_first_run(r, r->current_cycle - 1, t->A[i]);
+        t->is_first_run[i] = false;
+    }
+
+    // Running -> Terminate
+    if (t->cpu_time[i] >= t->C[i])
+    {
+        t->status[i] = TERMINATED;
+        t->finished_time[i] = r->current_cycle;
+
+        r->total_finished_processes++;
+        record_termination(r, r->current_cycle - t->A[i], t->waiting_time[i], t->blocked_time[i]);
+        return true;
+    }
+
+    // Running -> Block
+    if (t->cpu_burst[i] <= 0)
+    {
+        t->status[i] = BLOCKED;
+        return true;
+    }
+
+    return false;
+}
+
+/// @brief Finds the first READY process at or after index `from`, wrapping around to the head.
+///
+/// This is the process a circular walk of the array starting at `from` reaches first.
+/// @return the index of the process, or NO_PROCESS if none is READY
+static inline uint32_t process_table_next_ready(const process_table_t *t, uint32_t from)
+{
+    from = from < t->size ? from : 0;
+
+    const uint8_t *found = memchr(t->status + from, READY, t->size - from);
+    if (found == NULL)
+    {
+        found = memchr(t->status, READY, from);
+    }
+
+    return found == NULL ? NO_PROCESS : (uint32_t)(found - t->status);
+}
+
+/// @brief Ready -> Running
+///
+/// The process was READY during this cycle's sweep, so the cycle it counted as waiting is given back.
+/// @param new_burst whether to draw a new CPU burst, false when resuming the burst of a preempted process
+static inline void process_table_dispatch(process_table_t *t, uint32_t i, bool new_burst)
+{
+    if (new_burst)
+    {
+        process_table_set_bursts(t, i);
+    }
+    t->status[i] = RUNNING;
+    t->waiting_time[i]--;
+}
+
+#endif // PROCESS_TABLE_H
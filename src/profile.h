@@ -0,0 +1,74 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Optional instrumentation of the scheduling engines, compiled in with -DSCHED_PROFILE (make scheduler_profile).
+ *
+ * A profiled run counts what the engine spends its cycles on (idle cycles, picks, enqueues, bursts drawn
+ * from the random source, events fired) and times every phase of the tick engines with the monotonic clock, into
+ * the profile_t of its scheduler_result_t. The report of every run then ends with the profile as one line of
+ * JSON. Without SCHED_PROFILE the profile_t field does not exist and every macro below expands to nothing, so
+ * the engines compile to exactly the code they had before. PROFILE_ADD still evaluates its count, which never
+ * has side effects, so a variable only counted is not reported as unused.
+ */
+
+/* The phases of a cycle of the tick engines, see engine.h */
+typedef enum
+{
+    PHASE_ARRIVE = 0, // Unstarted -> Ready
+    PHASE_SWEEP = 1,  // Blocked -> Ready, and queueing the woken processes
+    PHASE_AGE = 2,    // The age hook of the policy
+    PHASE_RUN = 3,    // Running for a cycle, and leaving the CPU
+    PHASE_PICK = 4,   // Ready -> Running
+    NUM_PHASES = 5
+} profile_phase;
+
+static const char *const PROFILE_PHASE_NAMES[NUM_PHASES] = {"arrive", "sweep", "age", "run", "pick"};
+
+#ifdef SCHED_PROFILE
+
+/* The counters and timers of a run */
+typedef struct
+{
+    uint64_t idle_cycles; // Tick engines only: cycles no process ran on any core
+    uint64_t picks;       // Asks for a process to dispatch: pick hook calls (tick engines) or run queue dequeues
+    uint64_t enqueues;    // Processes handed to a ready queue
+    uint64_t burst_draws; // CPU bursts drawn from the random source, see set_bursts()
+    uint64_t events;      // Event engine only: timers fired
+
+    uint64_t total_ns;             // Wall time of the whole run
+    uint64_t phase_ns[NUM_PHASES]; // Wall time of every phase, tick engines only
+} profile_t;
+
+/// @brief Nanoseconds on the monotonic clock
+static inline uint64_t profile_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+#define PROFILE_ADD(r, counter, n) ((r)->profile.counter += (n))
+#define PROFILE_CLOCK(clock) uint64_t clock = profile_now()
+#define PROFILE_LAP(r, phase, clock)                          \
+    do                                                        \
+    {                                                         \
+        uint64_t profile_lap_ = profile_now();                \
+        (r)->profile.phase_ns[phase] += profile_lap_ - clock; \
+        clock = profile_lap_;                                 \
+    } while (0)
+#define PROFILE_TOTAL(r, clock) ((r)->profile.total_ns = profile_now() - clock)
+
+#else
+
+#define PROFILE_ADD(r, counter, n) ((void)(n))
+#define PROFILE_CLOCK(clock)
+#define PROFILE_LAP(r, phase, clock) ((void)0)
+#define PROFILE_TOTAL(r, clock) ((void)0)
+
+#endif // SCHED_PROFILE
+
+#endif // PROFILE_H
@@ -1,63 +1,316 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "allocator.h"
+
+static const char RANDOM_NUMBER_FILE_NAME[] = "./random-numbers"; // File name for random numbers
+static const char RANDOM_NUMBER_CACHE_SUFFIX[] = ".bin";           // Suffix of the binary sidecar cache of the random numbers
+static const uint32_t SEED_VALUE = 200;                           // Seed value for reading from file
+static const uint32_t RANDOM_FAIL_SAFE_VALUE = 1804289383;        // Returned for lines past the end of the file
+
+static const char RANDOM_CACHE_MAGIC[4] = {'R', 'N', 'D', 'T'}; // Magic bytes of the binary sidecar
+static const uint32_t RANDOM_CACHE_VERSION = 1;                 // Version of the binary sidecar layout
+
+/* Header of the binary sidecar, followed by `count` little-endian uint32_t values */
+typedef struct
+{
+    char magic[4];        // RANDOM_CACHE_MAGIC
+    uint32_t version;     // RANDOM_CACHE_VERSION
+    uint32_t count;       // The amount of values following the header
+    uint32_t reserved;    // Keeps the values 8 byte aligned
+    int64_t source_size;  // Size of the text file the sidecar was built from
+    int64_t source_mtime; // Modification time of the text file the sidecar was built from
+} random_cache_header_t;
+
+/* A table of every number in the random number file, indexed by line. Only read once loaded, so any number of
+   schedulers may draw from one table at the same time. */
+typedef struct
+{
+    uint32_t *values; // values[i] is the number on line i + 1
+    uint32_t count;   // The amount of lines read
 
-const char *RANDOM_NUMBER_FILE_NAME = "./random-numbers"; // File name for random numbers
-const uint32_t SEED_VALUE = 200;                          // Seed value for reading from file
+    void *map;      // The mapped sidecar backing `values`, or NULL when `values` comes from the allocator
+    size_t map_len; // Length of `map`
 
-// Additional variables as needed
+    const sched_allocator_t *allocator; // Where `values` comes from when it is not mapped
+} random_table_t;
+
+/// @brief Parses one line the same way atoi() does, advancing the cursor past the newline
+static inline uint32_t parse_random_line(const char **cursor, const char *end)
+{
+    const char *c = *cursor;
+    while (c < end && *c != '\n' && (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\v' || *c == '\f'))
+    {
+        c++;
+    }
+
+    int negative = 0;
+    if (c < end && (*c == '-' || *c == '+'))
+    {
+        negative = *c == '-';
+        c++;
+    }
+
+    int64_t value = 0;
+    while (c < end && *c >= '0' && *c <= '9')
+    {
+        value = value * 10 + (*c - '0');
+        c++;
+    }
+
+    while (c < end && *c != '\n')
+    {
+        c++;
+    }
+    *cursor = c < end ? c + 1 : end;
+
+    return (uint32_t)(int32_t)(negative ? -value : value);
+}
+
+/// @brief Builds the path of the binary sidecar for a random number file. Caller frees.
+static inline char *random_cache_path(const char *path, const sched_allocator_t *allocator)
+{
+    size_t len = strlen(path);
+    char *cache_path = sched_malloc(allocator, len + strlen(RANDOM_NUMBER_CACHE_SUFFIX) + 1, sizeof(char));
+    memcpy(cache_path, path, len);
+    strcpy(cache_path + len, RANDOM_NUMBER_CACHE_SUFFIX);
+    return cache_path;
+}
+
+/// @brief Maps the binary sidecar if it exists and was built from the current text file
+/// @return 1 on success, 0 if the sidecar is missing, stale or malformed
+static inline int random_table_map_cache(random_table_t *t, const char *cache_path, const struct stat *source)
+{
+    int fd = open(cache_path, O_RDONLY);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(random_cache_header_t))
+    {
+        close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return 0;
+    }
+
+    const random_cache_header_t *h = map;
+    if (memcmp(h->magic, RANDOM_CACHE_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != RANDOM_CACHE_VERSION ||
+        h->source_size != (int64_t)source->st_size ||
+        h->source_mtime != (int64_t)source->st_mtime ||
+        (size_t)st.st_size != sizeof(random_cache_header_t) + (size_t)h->count * sizeof(uint32_t))
+    {
+        munmap(map, st.st_size);
+        return 0;
+    }
+
+    t->values = (uint32_t *)(h + 1);
+    t->count = h->count;
+    t->map = map;
+    t->map_len = st.st_size;
+    return 1;
+}
+
+/// @brief Writes the binary sidecar for a parsed table. Best effort, failures are ignored.
+static inline void random_table_write_cache(const random_table_t *t, const char *cache_path, const struct stat *source)
+{
+    size_t tmp_len = strlen(cache_path) + 16;
+    char *tmp_path = sched_malloc(t->allocator, tmp_len, sizeof(char));
+    snprintf(tmp_path, tmp_len, "%s.%d", cache_path, (int)getpid());
+
+    FILE *f = fopen(tmp_path, "wb");
+    if (f == NULL)
+    {
+        sched_free(t->allocator, tmp_path);
+        return;
+    }
+
+    random_cache_header_t h = {
+        .version = RANDOM_CACHE_VERSION,
+        .count = t->count,
+        .source_size = source->st_size,
+        .source_mtime = source->st_mtime,
+    };
+    memcpy(h.magic, RANDOM_CACHE_MAGIC, sizeof(h.magic));
+
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+             fwrite(t->values, sizeof(uint32_t), t->count, f) == t->count;
+    ok = fclose(f) == 0 && ok;
+
+    // Rename so concurrent readers never see a partially written sidecar
+    if (!ok || rename(tmp_path, cache_path) != 0)
+    {
+        unlink(tmp_path);
+    }
+    sched_free(t->allocator, tmp_path);
+}
 
 /**
- * Reads a random non-negative integer X from a file with a given line named random-numbers (in the current directory)
+ * Loads every number of a random number file into memory.
+ * Uses the binary sidecar (path + RANDOM_NUMBER_CACHE_SUFFIX) when it is up to date,
+ * otherwise parses the text file once and, if write_cache is set, refreshes the sidecar.
+ * The parsed numbers and every temporary come from the allocator, NULL for malloc.
+ * Returns 1 on success, 0 if the file could not be read.
  */
-uint32_t getRandNumFromFile(uint32_t line, FILE *random_num_file_ptr)
+static inline int random_table_load(random_table_t *t, const char *path, bool write_cache,
+                                    const sched_allocator_t *allocator)
 {
-    uint32_t end, loop;
-    char str[512];
+    *t = (random_table_t){.allocator = allocator};
 
-    rewind(random_num_file_ptr); // reset to be beginning
-    for (end = loop = 0; loop < line; ++loop)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
     {
-        if (0 == fgets(str, sizeof(str), random_num_file_ptr))
-        {            // include '\n'
-            end = 1; // can't input (EOF)
-            break;
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return 0;
+    }
+
+    char *cache_path = random_cache_path(path, allocator);
+    if (random_table_map_cache(t, cache_path, &st))
+    {
+        sched_free(allocator, cache_path);
+        close(fd);
+        return 1;
+    }
+
+    const char *text = NULL;
+    if (st.st_size > 0)
+    {
+        text = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (text == MAP_FAILED)
+        {
+            sched_free(allocator, cache_path);
+            close(fd);
+            return 0;
         }
     }
-    if (!end)
+    close(fd);
+
+    // Every line holds one number, so the newline count bounds the table size
+    const char *end = text + st.st_size;
+    uint32_t lines = 0;
+    for (const char *c = text; c < end; c++)
     {
-        return (uint32_t)atoi(str);
+        lines += *c == '\n';
     }
+    lines += st.st_size > 0 && end[-1] != '\n';
 
-    // fail-safe return
-    return (uint32_t)1804289383;
+    t->values = sched_malloc(allocator, lines, sizeof(uint32_t));
+    for (const char *c = text; c < end;)
+    {
+        t->values[t->count++] = parse_random_line(&c, end);
+    }
+
+    if (text != NULL)
+    {
+        munmap((void *)text, st.st_size);
+    }
+
+#ifndef RANDOM_NO_CACHE
+    if (write_cache)
+    {
+        random_table_write_cache(t, cache_path, &st);
+    }
+#endif
+    sched_free(allocator, cache_path);
+    return 1;
+}
+
+/// @brief Builds a table holding a copy of the numbers, values[i] standing for line i + 1
+/// @param allocator where the copy comes from, NULL for malloc
+static inline void random_table_init(random_table_t *t, const uint32_t *values, uint32_t count,
+                                     const sched_allocator_t *allocator)
+{
+    *t = (random_table_t){.count = count, .allocator = allocator};
+    t->values = sched_malloc(allocator, count, sizeof(uint32_t));
+    memcpy(t->values, values, sizeof(uint32_t) * count);
+}
+
+/// @brief Releases the memory held by a random table
+static inline void random_table_free(random_table_t *t)
+{
+    if (t->map != NULL)
+    {
+        munmap(t->map, t->map_len);
+    }
+    else
+    {
+        sched_free(t->allocator, t->values);
+    }
+    *t = (random_table_t){0};
 }
 
-#ifndef UNIT_TEST_ENV
 /**
- * Reads a random non-negative integer X from a file named random-numbers.
- * Returns the CPU Burst: : 1 + (random-number-from-file % upper_bound)
+ * Reads a random non-negative integer X at a given line (starting at 1) of the random number table
  */
-uint32_t randomOS(uint32_t upper_bound, uint32_t process_indx, FILE *random_num_file_ptr)
+static inline uint32_t getRandNumFromTable(uint32_t line, const random_table_t *t)
 {
-    if (random_num_file_ptr == NULL)
+    if (line >= 1 && line <= t->count)
     {
-        random_num_file_ptr = fopen(RANDOM_NUMBER_FILE_NAME, "r");
-        assert(random_num_file_ptr != NULL);
+        return t->values[line - 1];
     }
 
-    char str[20];
+    // fail-safe return
+    return RANDOM_FAIL_SAFE_VALUE;
+}
 
-    uint32_t unsigned_rand_int = (uint32_t)getRandNumFromFile(SEED_VALUE + process_indx, random_num_file_ptr);
+#ifndef UNIT_TEST_ENV
+/**
+ * Reads a random non-negative integer X from a table loaded from the file named random-numbers.
+ * Returns the CPU Burst: : 1 + (random-number-from-file % upper_bound)
+ */
+static inline uint32_t randomOS(const random_table_t *t, uint32_t upper_bound, uint32_t process_indx)
+{
+    uint32_t unsigned_rand_int = getRandNumFromTable(SEED_VALUE + process_indx, t);
     uint32_t returnValue = 1 + (unsigned_rand_int % upper_bound);
 
     return returnValue;
 }
+
+/**
+ * Draws a ticket 0 .. num_tickets - 1 for a lottery, from the number of the table at line 1 + draw, wrapping
+ * around past the end of the table, so a run draws the same tickets every time.
+ */
+static inline uint32_t random_ticket(const random_table_t *t, uint64_t num_tickets, uint64_t draw)
+{
+    uint32_t line = t->count ? 1 + (uint32_t)(draw % t->count) : 1;
+    return (uint32_t)(getRandNumFromTable(line, t) % num_tickets);
+}
 #else
 /// @brief Returns a fixed value for testing purposes
-uint32_t randomOS(uint32_t upper_bound, uint32_t process_indx, FILE *random_num_file_ptr)
+static inline uint32_t randomOS(const random_table_t *t, uint32_t upper_bound, uint32_t process_indx)
+{
+    return 1 + (RANDOM_FAIL_SAFE_VALUE) % upper_bound;
+}
+
+/// @brief Returns a fixed sequence of tickets for testing purposes, spread evenly over the tickets
+static inline uint32_t random_ticket(const random_table_t *t, uint64_t num_tickets, uint64_t draw)
 {
-    return 1 + (1804289383) % upper_bound;
+    return (uint32_t)((RANDOM_FAIL_SAFE_VALUE + draw * 2654435761u) % num_tickets);
 }
-#endif
\ No newline at end of file
+#endif
+
+#endif // RANDOM_H
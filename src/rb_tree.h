@@ -0,0 +1,351 @@
+#ifndef RB_TREE_H
+#define RB_TREE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "allocator.h"
+
+/*
+ * Red-black tree of process indices ordered by a 64 bit key (e.g. the virtual runtime for CFS), with ties
+ * broken by the lower index like the ready queue.
+ *
+ * The tree is intrusive: the links and colour of process i live at index i of per-process arrays, so
+ * queueing allocates nothing. Index `capacity` is the sentinel leaf, whose parent link is scratch space for
+ * the removal as in CLRS. The leftmost process is cached, so the smallest key is found in O(1) and inserts
+ * and removals are O(log N).
+ */
+
+#define RB_BLACK 0
+#define RB_RED 1
+
+typedef struct
+{
+    uint32_t *left;
+    uint32_t *right;
+    uint32_t *parent;
+    uint8_t *color;
+    uint64_t *key; // key[indx] is the key process indx is queued with
+
+    uint32_t root;
+    uint32_t nil;      // The sentinel leaf
+    uint32_t leftmost; // The process with the smallest key, nil when empty
+    uint32_t size;     // The number of queued processes
+
+    const sched_allocator_t *allocator; // Where the per-process arrays come from
+} rb_tree_t;
+
+/// @brief Allocates an empty tree able to hold the processes 0 .. total_num_of_process - 1
+/// @param allocator where the per-process arrays come from, NULL for malloc
+static inline void rb_tree_init(rb_tree_t *t, uint32_t total_num_of_process, const sched_allocator_t *allocator)
+{
+    uint32_t n = total_num_of_process + 1;
+
+    t->allocator = allocator;
+    t->left = sched_malloc(allocator, n, sizeof(uint32_t));
+    t->right = sched_malloc(allocator, n, sizeof(uint32_t));
+    t->parent = sched_malloc(allocator, n, sizeof(uint32_t));
+    t->color = sched_malloc(allocator, n, sizeof(uint8_t));
+    t->key = sched_malloc(allocator, n, sizeof(uint64_t));
+
+    t->nil = total_num_of_process;
+    t->color[t->nil] = RB_BLACK;
+    t->left[t->nil] = t->right[t->nil] = t->parent[t->nil] = t->nil;
+    t->root = t->leftmost = t->nil;
+    t->size = 0;
+}
+
+static inline void rb_tree_free(rb_tree_t *t)
+{
+    sched_free(t->allocator, t->left);
+    sched_free(t->allocator, t->right);
+    sched_free(t->allocator, t->parent);
+    sched_free(t->allocator, t->color);
+    sched_free(t->allocator, t->key);
+    *t = (rb_tree_t){0};
+}
+
+static inline bool rb_tree_empty(const rb_tree_t *t)
+{
+    return t->size == 0;
+}
+
+/// @brief The process with the smallest key, without removing it. The tree must not be empty.
+static inline uint32_t rb_tree_first(const rb_tree_t *t)
+{
+    return t->leftmost;
+}
+
+static inline bool rb_tree_less(const rb_tree_t *t, uint32_t a, uint32_t b)
+{
+    return t->key[a] < t->key[b] || (t->key[a] == t->key[b] && a < b);
+}
+
+/// @brief Points the link of x's parent at y instead of x
+static inline void rb_tree_replace_child(rb_tree_t *t, uint32_t x, uint32_t y)
+{
+    uint32_t p = t->parent[x];
+    if (p == t->nil)
+    {
+        t->root = y;
+    }
+    else if (x == t->left[p])
+    {
+        t->left[p] = y;
+    }
+    else
+    {
+        t->right[p] = y;
+    }
+    t->parent[y] = p;
+}
+
+static inline void rb_tree_rotate_left(rb_tree_t *t, uint32_t x)
+{
+    uint32_t y = t->right[x];
+    t->right[x] = t->left[y];
+    if (t->left[y] != t->nil)
+    {
+        t->parent[t->left[y]] = x;
+    }
+    rb_tree_replace_child(t, x, y);
+    t->left[y] = x;
+    t->parent[x] = y;
+}
+
+static inline void rb_tree_rotate_right(rb_tree_t *t, uint32_t x)
+{
+    uint32_t y = t->left[x];
+    t->left[x] = t->right[y];
+    if (t->right[y] != t->nil)
+    {
+        t->parent[t->right[y]] = x;
+    }
+    rb_tree_replace_child(t, x, y);
+    t->right[y] = x;
+    t->parent[x] = y;
+}
+
+/// @brief Queues a process that is not already queued
+static inline void rb_tree_insert(rb_tree_t *t, uint32_t z, uint64_t key)
+{
+    t->key[z] = key;
+
+    uint32_t y = t->nil;
+    bool leftmost = true;
+    for (uint32_t x = t->root; x != t->nil;)
+    {
+        y = x;
+        if (rb_tree_less(t, z, x))
+        {
+            x = t->left[x];
+        }
+        else
+        {
+            x = t->right[x];
+            leftmost = false;
+        }
+    }
+
+    t->parent[z] = y;
+    if (y == t->nil)
+    {
+        t->root = z;
+    }
+    else if (rb_tree_less(t, z, y))
+    {
+        t->left[y] = z;
+    }
+    else
+    {
+        t->right[y] = z;
+    }
+    t->left[z] = t->right[z] = t->nil;
+    t->color[z] = RB_RED;
+    if (leftmost)
+    {
+        t->leftmost = z;
+    }
+    t->size++;
+
+    // Restores the colour rules, the sentinel being black ends the walk at the root
+    while (t->color[t->parent[z]] == RB_RED)
+    {
+        uint32_t p = t->parent[z];
+        uint32_t g = t->parent[p];
+        if (p == t->left[g])
+        {
+            uint32_t u = t->right[g];
+            if (t->color[u] == RB_RED)
+            {
+                t->color[p] = t->color[u] = RB_BLACK;
+                t->color[g] = RB_RED;
+                z = g;
+                continue;
+            }
+            if (z == t->right[p])
+            {
+                z = p;
+                rb_tree_rotate_left(t, z);
+                p = t->parent[z];
+            }
+            t->color[p] = RB_BLACK;
+            t->color[g] = RB_RED;
+            rb_tree_rotate_right(t, g);
+        }
+        else
+        {
+            uint32_t u = t->left[g];
+            if (t->color[u] == RB_RED)
+            {
+                t->color[p] = t->color[u] = RB_BLACK;
+                t->color[g] = RB_RED;
+                z = g;
+                continue;
+            }
+            if (z == t->left[p])
+            {
+                z = p;
+                rb_tree_rotate_right(t, z);
+                p = t->parent[z];
+            }
+            t->color[p] = RB_BLACK;
+            t->color[g] = RB_RED;
+            rb_tree_rotate_left(t, g);
+        }
+    }
+    t->color[t->root] = RB_BLACK;
+}
+
+static inline uint32_t rb_tree_minimum(const rb_tree_t *t, uint32_t x)
+{
+    while (t->left[x] != t->nil)
+    {
+        x = t->left[x];
+    }
+    return x;
+}
+
+/// @brief Unlinks a queued process
+static inline void rb_tree_remove(rb_tree_t *t, uint32_t z)
+{
+    // The leftmost process has no left child, so the next one is down its right subtree or its parent
+    if (z == t->leftmost)
+    {
+        t->leftmost = t->right[z] != t->nil ? rb_tree_minimum(t, t->right[z]) : t->parent[z];
+    }
+
+    uint32_t y = z;
+    uint8_t removed_color = t->color[y];
+    uint32_t x;
+    if (t->left[z] == t->nil)
+    {
+        x = t->right[z];
+        rb_tree_replace_child(t, z, x);
+    }
+    else if (t->right[z] == t->nil)
+    {
+        x = t->left[z];
+        rb_tree_replace_child(t, z, x);
+    }
+    else
+    {
+        y = rb_tree_minimum(t, t->right[z]);
+        removed_color = t->color[y];
+        x = t->right[y];
+        if (t->parent[y] == z)
+        {
+            t->parent[x] = y;
+        }
+        else
+        {
+            rb_tree_replace_child(t, y, x);
+            t->right[y] = t->right[z];
+            t->parent[t->right[y]] = y;
+        }
+        rb_tree_replace_child(t, z, y);
+        t->left[y] = t->left[z];
+        t->parent[t->left[y]] = y;
+        t->color[y] = t->color[z];
+    }
+    t->size--;
+
+    if (removed_color == RB_RED)
+    {
+        return;
+    }
+
+    // x carries an extra black up the tree until it can be absorbed
+    while (x != t->root && t->color[x] == RB_BLACK)
+    {
+        uint32_t p = t->parent[x];
+        if (x == t->left[p])
+        {
+            uint32_t s = t->right[p];
+            if (t->color[s] == RB_RED)
+            {
+                t->color[s] = RB_BLACK;
+                t->color[p] = RB_RED;
+                rb_tree_rotate_left(t, p);
+                s = t->right[p];
+            }
+            if (t->color[t->left[s]] == RB_BLACK && t->color[t->right[s]] == RB_BLACK)
+            {
+                t->color[s] = RB_RED;
+                x = p;
+                continue;
+            }
+            if (t->color[t->right[s]] == RB_BLACK)
+            {
+                t->color[t->left[s]] = RB_BLACK;
+                t->color[s] = RB_RED;
+                rb_tree_rotate_right(t, s);
+                s = t->right[p];
+            }
+            t->color[s] = t->color[p];
+            t->color[p] = RB_BLACK;
+            t->color[t->right[s]] = RB_BLACK;
+            rb_tree_rotate_left(t, p);
+        }
+        else
+        {
+            uint32_t s = t->left[p];
+            if (t->color[s] == RB_RED)
+            {
+                t->color[s] = RB_BLACK;
+                t->color[p] = RB_RED;
+                rb_tree_rotate_right(t, p);
+                s = t->left[p];
+            }
+            if (t->color[t->left[s]] == RB_BLACK && t->color[t->right[s]] == RB_BLACK)
+            {
+                t->color[s] = RB_RED;
+                x = p;
+                continue;
+            }
+            if (t->color[t->left[s]] == RB_BLACK)
+            {
+                t->color[t->right[s]] = RB_BLACK;
+                t->color[s] = RB_RED;
+                rb_tree_rotate_left(t, s);
+                s = t->left[p];
+            }
+            t->color[s] = t->color[p];
+            t->color[p] = RB_BLACK;
+            t->color[t->left[s]] = RB_BLACK;
+            rb_tree_rotate_right(t, p);
+        }
+        x = t->root;
+    }
+    t->color[x] = RB_BLACK;
+}
+
+/// @brief Removes and returns the process with the smallest key. The tree must not be empty.
+static inline uint32_t rb_tree_pop_first(rb_tree_t *t)
+{
+    uint32_t first = t->leftmost;
+    rb_tree_remove(t, first);
+    return first;
+}
+
+#endif // RB_TREE_H
@@ -0,0 +1,340 @@
+#ifndef READY_QUEUE_H
+#define READY_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "allocator.h"
+
+/*
+ * Ready queue shared by the priority based schedulers.
+ *
+ * A binary min-heap of process indices ordered by a 64 bit key (e.g. the remaining CPU time for SJF),
+ * with ties broken by the lower index. Process arrays are sorted by arrival time before scheduling, so
+ * the index tie-break keeps the order a front-to-back scan of the array would pick.
+ *
+ * The circular policies (FCFS, RR) use a ready_set_t instead, a bitmap picking the first READY index
+ * after a given one, the way the tick schedulers scan the array.
+ *
+ * The multi-level feedback queue uses a level_queue_t: a FIFO per level, threaded through per-process
+ * next/prev links so queueing allocates nothing, and a bitmap of the non-empty levels so the first
+ * process of the best level is found with one count of trailing zeros.
+ */
+
+#define READY_QUEUE_ABSENT UINT32_MAX // Position of a process that is not queued
+
+typedef struct
+{
+    uint32_t *heap; // Process indices in heap order
+    uint32_t *pos;  // pos[indx] is the slot of process indx in heap, or READY_QUEUE_ABSENT
+    uint64_t *keys; // keys[indx] is the key process indx is queued with
+    uint32_t size;  // The number of queued processes
+
+    const sched_allocator_t *allocator; // Where the arrays come from
+} ready_queue_t;
+
+/// @brief Allocates a ready queue able to hold the processes 0 .. total_num_of_process - 1
+/// @param allocator where the arrays come from, NULL for malloc
+static inline void ready_queue_init(ready_queue_t *q, uint32_t total_num_of_process, const sched_allocator_t *allocator)
+{
+    uint32_t n = total_num_of_process ? total_num_of_process : 1;
+
+    q->allocator = allocator;
+    q->heap = sched_malloc(allocator, n, sizeof(uint32_t));
+    q->pos = sched_malloc(allocator, n, sizeof(uint32_t));
+    q->keys = sched_malloc(allocator, n, sizeof(uint64_t));
+    q->size = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        q->pos[i] = READY_QUEUE_ABSENT;
+    }
+}
+
+static inline void ready_queue_free(ready_queue_t *q)
+{
+    sched_free(q->allocator, q->heap);
+    sched_free(q->allocator, q->pos);
+    sched_free(q->allocator, q->keys);
+    *q = (ready_queue_t){0};
+}
+
+static inline bool ready_queue_less(const ready_queue_t *q, uint32_t a, uint32_t b)
+{
+    return q->keys[a] < q->keys[b] || (q->keys[a] == q->keys[b] && a < b);
+}
+
+static inline void ready_queue_place(ready_queue_t *q, uint32_t slot, uint32_t indx)
+{
+    q->heap[slot] = indx;
+    q->pos[indx] = slot;
+}
+
+static inline void ready_queue_sift_up(ready_queue_t *q, uint32_t slot)
+{
+    uint32_t indx = q->heap[slot];
+    while (slot > 0 && ready_queue_less(q, indx, q->heap[(slot - 1) / 2]))
+    {
+        ready_queue_place(q, slot, q->heap[(slot - 1) / 2]);
+        slot = (slot - 1) / 2;
+    }
+    ready_queue_place(q, slot, indx);
+}
+
+static inline void ready_queue_sift_down(ready_queue_t *q, uint32_t slot)
+{
+    uint32_t indx = q->heap[slot];
+    for (;;)
+    {
+        uint32_t c = 2 * slot + 1;
+        if (c >= q->size)
+        {
+            break;
+        }
+        if (c + 1 < q->size && ready_queue_less(q, q->heap[c + 1], q->heap[c]))
+        {
+            c++;
+        }
+        if (!ready_queue_less(q, q->heap[c], indx))
+        {
+            break;
+        }
+        ready_queue_place(q, slot, q->heap[c]);
+        slot = c;
+    }
+    ready_queue_place(q, slot, indx);
+}
+
+static inline bool ready_queue_empty(const ready_queue_t *q)
+{
+    return q->size == 0;
+}
+
+static inline bool ready_queue_contains(const ready_queue_t *q, uint32_t indx)
+{
+    return q->pos[indx] != READY_QUEUE_ABSENT;
+}
+
+/// @brief Queues a process that is not already queued
+static inline void ready_queue_push(ready_queue_t *q, uint32_t indx, uint64_t key)
+{
+    q->keys[indx] = key;
+    q->heap[q->size] = indx;
+    ready_queue_sift_up(q, q->size++);
+}
+
+/// @brief Lowers the key of a queued process in O(log N), e.g. when aging a waiting process
+static inline void ready_queue_decrease_key(ready_queue_t *q, uint32_t indx, uint64_t key)
+{
+    q->keys[indx] = key;
+    ready_queue_sift_up(q, q->pos[indx]);
+}
+
+/// @brief The process with the smallest key, without removing it. The queue must not be empty.
+static inline uint32_t ready_queue_peek(const ready_queue_t *q)
+{
+    return q->heap[0];
+}
+
+/// @brief Removes and returns the process with the smallest key. The queue must not be empty.
+static inline uint32_t ready_queue_pop(ready_queue_t *q)
+{
+    uint32_t top = q->heap[0];
+    q->pos[top] = READY_QUEUE_ABSENT;
+
+    if (--q->size > 0)
+    {
+        q->heap[0] = q->heap[q->size];
+        ready_queue_sift_down(q, 0);
+    }
+    return top;
+}
+
+/* Set of READY processes, one bit per index of the process array */
+typedef struct
+{
+    uint64_t *words;
+    uint32_t num_words;
+    uint32_t size; // The number of bits set
+
+    const sched_allocator_t *allocator; // Where the bitmap comes from
+} ready_set_t;
+
+/// @brief Allocates an empty set for the processes 0 .. total_num_of_process - 1
+/// @param allocator where the bitmap comes from, NULL for malloc
+static inline void ready_set_init(ready_set_t *s, uint32_t total_num_of_process, const sched_allocator_t *allocator)
+{
+    s->allocator = allocator;
+    s->num_words = (total_num_of_process + 63) / 64;
+    s->words = sched_calloc(allocator, s->num_words, sizeof(uint64_t));
+    s->size = 0;
+}
+
+static inline void ready_set_free(ready_set_t *s)
+{
+    sched_free(s->allocator, s->words);
+    *s = (ready_set_t){0};
+}
+
+static inline void ready_set_add(ready_set_t *s, uint32_t i)
+{
+    s->words[i / 64] |= 1ull << (i % 64);
+    s->size++;
+}
+
+static inline void ready_set_remove(ready_set_t *s, uint32_t i)
+{
+    s->words[i / 64] &= ~(1ull << (i % 64));
+    s->size--;
+}
+
+/// @brief Finds the first READY index at or after `from`, wrapping around to the head.
+///
+/// This is the process the circular scan of the tick engine would reach first. The set must not be empty.
+static inline uint32_t ready_set_next(const ready_set_t *s, uint32_t from)
+{
+    uint32_t w = from / 64;
+    uint64_t bits = w < s->num_words ? s->words[w] & (~0ull << (from % 64)) : 0;
+
+    for (uint32_t visited = 0; visited <= s->num_words; visited++)
+    {
+        if (bits)
+        {
+            return w * 64 + __builtin_ctzll(bits);
+        }
+        w = w + 1 < s->num_words ? w + 1 : 0;
+        bits = s->words[w];
+    }
+
+    assert(false);
+    return 0;
+}
+
+#define LEVEL_QUEUE_MAX_LEVELS 32 // One bit of the level bitmap per level
+
+/* READY processes in FIFO order on each level, level 0 first */
+typedef struct
+{
+    uint32_t *next; // next[indx] is the process after indx on its level, or READY_QUEUE_ABSENT
+    uint32_t *prev; // prev[indx] is the process before indx on its level, or READY_QUEUE_ABSENT
+    uint32_t head[LEVEL_QUEUE_MAX_LEVELS];
+    uint32_t tail[LEVEL_QUEUE_MAX_LEVELS];
+    uint32_t nonempty; // Bit l is set when level l has a process queued
+
+    const sched_allocator_t *allocator; // Where the links come from
+} level_queue_t;
+
+/// @brief Allocates empty levels for the processes 0 .. total_num_of_process - 1
+/// @param allocator where the links come from, NULL for malloc
+static inline void level_queue_init(level_queue_t *q, uint32_t total_num_of_process, const sched_allocator_t *allocator)
+{
+    uint32_t n = total_num_of_process ? total_num_of_process : 1;
+
+    q->allocator = allocator;
+    q->next = sched_malloc(allocator, n, sizeof(uint32_t));
+    q->prev = sched_malloc(allocator, n, sizeof(uint32_t));
+    for (uint32_t l = 0; l < LEVEL_QUEUE_MAX_LEVELS; l++)
+    {
+        q->head[l] = q->tail[l] = READY_QUEUE_ABSENT;
+    }
+    q->nonempty = 0;
+}
+
+static inline void level_queue_free(level_queue_t *q)
+{
+    sched_free(q->allocator, q->next);
+    sched_free(q->allocator, q->prev);
+    *q = (level_queue_t){0};
+}
+
+static inline bool level_queue_empty(const level_queue_t *q)
+{
+    return q->nonempty == 0;
+}
+
+/// @brief The best (lowest) level with a process queued. The queue must not be empty.
+static inline uint32_t level_queue_first_level(const level_queue_t *q)
+{
+    return __builtin_ctz(q->nonempty);
+}
+
+/// @brief Queues a process that is not already queued at the back of a level
+static inline void level_queue_push(level_queue_t *q, uint32_t level, uint32_t indx)
+{
+    uint32_t tail = q->tail[level];
+    q->next[indx] = READY_QUEUE_ABSENT;
+    q->prev[indx] = tail;
+    if (tail == READY_QUEUE_ABSENT)
+    {
+        q->head[level] = indx;
+        q->nonempty |= 1u << level;
+    }
+    else
+    {
+        q->next[tail] = indx;
+    }
+    q->tail[level] = indx;
+}
+
+/// @brief Unlinks a process queued on the given level in O(1)
+static inline void level_queue_remove(level_queue_t *q, uint32_t level, uint32_t indx)
+{
+    uint32_t next = q->next[indx];
+    uint32_t prev = q->prev[indx];
+
+    if (prev == READY_QUEUE_ABSENT)
+    {
+        q->head[level] = next;
+    }
+    else
+    {
+        q->next[prev] = next;
+    }
+
+    if (next == READY_QUEUE_ABSENT)
+    {
+        q->tail[level] = prev;
+    }
+    else
+    {
+        q->prev[next] = prev;
+    }
+
+    if (q->head[level] == READY_QUEUE_ABSENT)
+    {
+        q->nonempty &= ~(1u << level);
+    }
+}
+
+/// @brief Removes and returns the first process of the best level. The queue must not be empty.
+static inline uint32_t level_queue_pop(level_queue_t *q)
+{
+    uint32_t level = level_queue_first_level(q);
+    uint32_t indx = q->head[level];
+    level_queue_remove(q, level, indx);
+    return indx;
+}
+
+/// @brief Moves every queued process to level 0, level by level and keeping their order, in O(levels)
+static inline void level_queue_merge_to_top(level_queue_t *q)
+{
+    for (uint32_t bits = q->nonempty & ~1u; bits; bits &= bits - 1)
+    {
+        uint32_t level = __builtin_ctz(bits);
+        if (q->tail[0] == READY_QUEUE_ABSENT)
+        {
+            q->head[0] = q->head[level];
+        }
+        else
+        {
+            q->next[q->tail[0]] = q->head[level];
+            q->prev[q->head[level]] = q->tail[0];
+        }
+        q->tail[0] = q->tail[level];
+        q->head[level] = q->tail[level] = READY_QUEUE_ABSENT;
+    }
+    q->nonempty = q->nonempty ? 1u : 0;
+}
+
+#endif // READY_QUEUE_H
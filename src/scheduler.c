@@ -1,186 +1,1029 @@
 #include <assert.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 #include "scheduler.h"
+#include "event.h"
+#include "multicore.h"
+#include "loader.h"
+#include "writer.h"
 
 /********************* SOME PRINTING HELPERS *********************/
 
 /**
- * Prints to standard output the original input
+ * Prints the original input to the writer
  * process_list is the original processes inputted (in array form)
  */
-void printStart(process_t process_list[], uint32_t size)
+void printStart(writer_t *w, process_t process_list[], uint32_t size)
 {
-    printf("The original input was: %i", size);
+    writer_str(w, "The original input was: ");
+    writer_int(w, (int32_t)size);
 
     uint32_t i = 0;
     for (; i < size; ++i)
     {
-        printf(" ( %i %i %i %i)", process_list[i].A, process_list[i].B,
-               process_list[i].C, process_list[i].M);
+        writer_str(w, " ( ");
+        writer_int(w, (int32_t)process_list[i].A);
+        writer_char(w, ' ');
+        writer_int(w, (int32_t)process_list[i].B);
+        writer_char(w, ' ');
+        writer_int(w, (int32_t)process_list[i].C);
+        writer_char(w, ' ');
+        writer_int(w, (int32_t)process_list[i].M);
+        writer_char(w, ')');
     }
-    printf("\n");
+    writer_char(w, '\n');
 }
 
 /**
- * Prints to standard output the final output
+ * Prints the final output to the writer
  * finished_process_list is the terminated processes (in array form) in the order they each finished in.
  */
-void printFinal(process_t finished_process_list[], scheduler_result_t result)
+void printFinal(writer_t *w, process_t finished_process_list[], const scheduler_result_t *result)
 {
-    printf("The (sorted) input is: %i", result.total_created_processes);
+    writer_str(w, "The (sorted) input is: ");
+    writer_int(w, (int32_t)result->total_created_processes);
 
     uint32_t i = 0;
-    for (; i < result.total_finished_processes; ++i)
+    for (; i < result->total_finished_processes; ++i)
     {
-        printf(" ( %i %i %i %i)", finished_process_list[i].A, finished_process_list[i].B,
-               finished_process_list[i].C, finished_process_list[i].M);
+        writer_str(w, " ( ");
+        writer_int(w, (int32_t)finished_process_list[i].A);
+        writer_char(w, ' ');
+        writer_int(w, (int32_t)finished_process_list[i].B);
+        writer_char(w, ' ');
+        writer_int(w, (int32_t)finished_process_list[i].C);
+        writer_char(w, ' ');
+        writer_int(w, (int32_t)finished_process_list[i].M);
+        writer_char(w, ')');
     }
-    printf("\n");
+    writer_char(w, '\n');
 } // End of the print final function
 
 /**
  * Prints out specifics for each process.
  * @param process_list The original processes inputted, in array form
  */
-void printProcessSpecifics(process_t process_list[], scheduler_result_t result)
+void printProcessSpecifics(writer_t *w, process_t process_list[], const scheduler_result_t *result)
 {
     uint32_t i = 0;
-    printf("\n");
-    for (; i < result.total_created_processes; ++i)
-    {
-        printf("Process %i:\n", process_list[i].id);
-        printf("\t(A,B,C,M) = (%i,%i,%i,%i)\n", process_list[i].A, process_list[i].B,
-               process_list[i].C, process_list[i].M);
-        printf("\tFinishing time: %i\n", process_list[i].finished_time);
-        printf("\tTurnaround time: %i\n", process_list[i].finished_time - process_list[i].A);
-        printf("\tI/O time: %i\n", process_list[i].blocked_time);
-        printf("\tWaiting time: %i\n", process_list[i].waiting_time);
-        printf("\n");
+    writer_char(w, '\n');
+    for (; i < result->total_created_processes; ++i)
+    {
+        writer_str(w, "Process ");
+        writer_int(w, (int32_t)process_list[i].id);
+        writer_str(w, ":\n\t(A,B,C,M) = (");
+        writer_int(w, (int32_t)process_list[i].A);
+        writer_char(w, ',');
+        writer_int(w, (int32_t)process_list[i].B);
+        writer_char(w, ',');
+        writer_int(w, (int32_t)process_list[i].C);
+        writer_char(w, ',');
+        writer_int(w, (int32_t)process_list[i].M);
+        writer_str(w, ")\n\tFinishing time: ");
+        writer_int(w, process_list[i].finished_time);
+        writer_str(w, "\n\tTurnaround time: ");
+        writer_int(w, (int32_t)(process_list[i].finished_time - process_list[i].A));
+        writer_str(w, "\n\tI/O time: ");
+        writer_int(w, (int32_t)process_list[i].blocked_time);
+        writer_str(w, "\n\tWaiting time: ");
+        writer_int(w, (int32_t)process_list[i].waiting_time);
+        writer_str(w, "\n\n");
     }
 } // End of the print process specifics function
 
+/* The summary figures of a run */
+typedef struct
+{
+    uint32_t finishing_time;
+    double cpu_util;
+    double io_util;
+    double throughput;
+    double avg_turnaround_time;
+    double avg_waiting_time;
+
+    // Over the processes with a deadline only
+    uint32_t num_deadlines;
+    uint32_t deadline_misses; // Processes that finished after their deadline
+    double miss_ratio;
+    int64_t max_lateness; // The most cycles a process finished after its deadline, negative when all were early
+} summary_t;
+
 /**
- * Prints out the summary data
- * process_list The original processes inputted, in array form
+ * Calculates the summary figures of a run
+ * process_list The processes after the run, in array form
  */
-void printSummaryData(process_t process_list[], scheduler_result_t result)
+summary_t summarise(process_t process_list[], const scheduler_result_t *result)
 {
     uint32_t i = 0;
     double total_amount_of_time_utilizing_cpu = 0.0;
     double total_amount_of_time_io_blocked = 0.0;
     double total_amount_of_time_spent_waiting = 0.0;
     double total_turnaround_time = 0.0;
-    uint32_t final_finishing_time = result.current_cycle - 1;
-    for (; i < result.total_created_processes; ++i)
+    uint32_t final_finishing_time = result->current_cycle - 1;
+    summary_t summary = {.finishing_time = final_finishing_time, .max_lateness = INT64_MIN};
+    for (; i < result->total_created_processes; ++i)
     {
         total_amount_of_time_utilizing_cpu += process_list[i].cpu_time;
         total_amount_of_time_io_blocked += process_list[i].blocked_time;
         total_amount_of_time_spent_waiting += process_list[i].waiting_time;
         total_turnaround_time += (process_list[i].finished_time - process_list[i].A);
+
+        if (process_list[i].deadline)
+        {
+            int64_t lateness = (int64_t)process_list[i].finished_time - process_list[i].A - process_list[i].deadline;
+            summary.num_deadlines++;
+            summary.deadline_misses += lateness > 0;
+            summary.max_lateness = lateness > summary.max_lateness ? lateness : summary.max_lateness;
+        }
     }
 
-    // Calculates the CPU utilisation
-    double cpu_util = total_amount_of_time_utilizing_cpu / final_finishing_time;
+    // Calculates the CPU utilisation, averaged over the cores of the multi-core schedulers
+    uint32_t num_cores = result->num_cores ? result->num_cores : 1;
+    summary.cpu_util = total_amount_of_time_utilizing_cpu / final_finishing_time / num_cores;
 
     // Calculates the IO utilisation
-    double io_util = (double)result.total_number_of_cycles_spent_blocked / final_finishing_time;
+    summary.io_util = (double)result->total_number_of_cycles_spent_blocked / final_finishing_time;
 
     // Calculates the throughput (Number of processes over the final finishing time times 100)
-    double throughput = 100 * ((double)result.total_created_processes / final_finishing_time);
+    summary.throughput = 100 * ((double)result->total_created_processes / final_finishing_time);
 
     // Calculates the average turnaround time
-    double avg_turnaround_time = total_turnaround_time / result.total_created_processes;
+    summary.avg_turnaround_time = total_turnaround_time / result->total_created_processes;
 
     // Calculates the average waiting time
-    double avg_waiting_time = total_amount_of_time_spent_waiting / result.total_created_processes;
-
-    printf("Summary Data:\n");
-    printf("\tFinishing time: %i\n", result.current_cycle - 1);
-    printf("\tCPU Utilisation: %6f\n", cpu_util);
-    printf("\tI/O Utilisation: %6f\n", io_util);
-    printf("\tThroughput: %6f processes per hundred cycles\n", throughput);
-    printf("\tAverage turnaround time: %6f\n", avg_turnaround_time);
-    printf("\tAverage waiting time: %6f\n", avg_waiting_time);
+    summary.avg_waiting_time = total_amount_of_time_spent_waiting / result->total_created_processes;
+
+    // Calculates the share of the deadlines missed
+    summary.miss_ratio = summary.num_deadlines ? (double)summary.deadline_misses / summary.num_deadlines : 0.0;
+
+    return summary;
+}
+
+/**
+ * Prints out the summary data
+ * process_list The original processes inputted, in array form
+ */
+void printSummaryData(writer_t *w, process_t process_list[], const scheduler_result_t *result)
+{
+    summary_t summary = summarise(process_list, result);
+
+    writer_str(w, "Summary Data:\n\tFinishing time: ");
+    writer_int(w, (int32_t)(result->current_cycle - 1));
+    writer_str(w, "\n\tCPU Utilisation: ");
+    writer_double6(w, summary.cpu_util);
+    writer_str(w, "\n\tI/O Utilisation: ");
+    writer_double6(w, summary.io_util);
+    writer_str(w, "\n\tThroughput: ");
+    writer_double6(w, summary.throughput);
+    writer_str(w, " processes per hundred cycles\n\tAverage turnaround time: ");
+    writer_double6(w, summary.avg_turnaround_time);
+    writer_str(w, "\n\tAverage waiting time: ");
+    writer_double6(w, summary.avg_waiting_time);
+    writer_char(w, '\n');
+
+    // Only inputs with deadlines report on them
+    if (summary.num_deadlines)
+    {
+        writer_str(w, "\tDeadline misses: ");
+        writer_uint(w, summary.deadline_misses);
+        writer_str(w, " of ");
+        writer_uint(w, summary.num_deadlines);
+        writer_str(w, "\n\tDeadline miss ratio: ");
+        writer_double6(w, summary.miss_ratio);
+        writer_str(w, "\n\tMaximum lateness: ");
+        writer_int(w, summary.max_lateness);
+        writer_char(w, '\n');
+    }
 } // End of the print summary data function
 
-void out(process_t *process_list, uint32_t size, char scheduler[3], scheduler_result_t (*f)(process_t *, uint32_t))
+/* A percentile reported for every latency, and its name in the report */
+typedef struct
+{
+    double q;
+    const char *name;
+} percentile_t;
+
+const percentile_t PERCENTILES[] = {{0.5, "p50"}, {0.9, "p90"}, {0.99, "p99"}, {0.999, "p99.9"}};
+const uint32_t NUM_PERCENTILES = sizeof(PERCENTILES) / sizeof(PERCENTILES[0]);
+
+/**
+ * Prints one latency distribution of a run as its percentiles and maximum
+ */
+void printLatency(writer_t *w, const char *name, const histogram_t *h)
+{
+    writer_char(w, '\t');
+    writer_str(w, name);
+    writer_char(w, ':');
+    for (uint32_t k = 0; k < NUM_PERCENTILES; ++k)
+    {
+        writer_char(w, ' ');
+        writer_str(w, PERCENTILES[k].name);
+        writer_char(w, ' ');
+        writer_uint(w, histogram_percentile(h, PERCENTILES[k].q));
+        writer_char(w, ',');
+    }
+    writer_str(w, " max ");
+    writer_uint(w, h->max);
+    writer_char(w, '\n');
+}
+
+/**
+ * Prints the tail of the latencies recorded while the processes ran, percentiles within 1/32 of the exact value
+ */
+void printLatencyData(writer_t *w, const scheduler_result_t *result)
+{
+    writer_str(w, "Latency Data:\n");
+    printLatency(w, "Turnaround time", &result->turnaround_times);
+    printLatency(w, "Waiting time", &result->waiting_times);
+    printLatency(w, "Response time", &result->response_times);
+    printLatency(w, "I/O time", &result->io_times);
+} // End of the print latency data function
+
+/* The fairness figures of a run */
+typedef struct
+{
+    double jain_index; // Jain's index of the CPU shares divided by the weights, 1 when perfectly proportional
+    double min_share;  // The least CPU share of a process, the CPU time over the time it was runnable
+    double max_share;
+} fairness_t;
+
+/**
+ * Calculates the fairness figures of a run, weighting every process as CFS does
+ * process_list The processes after the run, in array form
+ */
+fairness_t summarise_fairness(process_t process_list[], const scheduler_result_t *result)
+{
+    fairness_t fairness = {.min_share = 1.0};
+    double sum = 0.0;
+    double sum_of_squares = 0.0;
+    for (uint32_t i = 0; i < result->total_created_processes; ++i)
+    {
+        uint32_t runnable = process_list[i].cpu_time + process_list[i].waiting_time;
+        double share = runnable ? (double)process_list[i].cpu_time / runnable : 1.0;
+        double weighted = share * CFS_NICE_0_WEIGHT / cfs_weight(process_list[i].priority);
+
+        sum += weighted;
+        sum_of_squares += weighted * weighted;
+        fairness.min_share = share < fairness.min_share ? share : fairness.min_share;
+        fairness.max_share = share > fairness.max_share ? share : fairness.max_share;
+    }
+
+    fairness.jain_index = sum_of_squares > 0 ? sum * sum / (result->total_created_processes * sum_of_squares) : 1.0;
+    return fairness;
+}
+
+/**
+ * Prints out the fairness figures, for the proportional share schedulers
+ */
+void printFairnessData(writer_t *w, process_t process_list[], const scheduler_result_t *result)
+{
+    fairness_t fairness = summarise_fairness(process_list, result);
+
+    writer_str(w, "Fairness Data:\n\tJain's index of weighted CPU share: ");
+    writer_double6(w, fairness.jain_index);
+    writer_str(w, "\n\tLowest CPU share: ");
+    writer_double6(w, fairness.min_share);
+    writer_str(w, "\n\tHighest CPU share: ");
+    writer_double6(w, fairness.max_share);
+    writer_char(w, '\n');
+} // End of the print fairness data function
+
+/**
+ * Prints out the utilisation and migrations of every core, for the multi-core schedulers
+ */
+void printCoreData(writer_t *w, const scheduler_result_t *result)
+{
+    uint32_t final_finishing_time = result->current_cycle - 1;
+
+    writer_str(w, "Core Data:\n");
+    for (uint32_t c = 0; c < result->num_cores; ++c)
+    {
+        writer_str(w, "\tCore ");
+        writer_uint(w, c);
+        writer_str(w, ": utilisation ");
+        writer_double6(w, (double)result->core_busy_cycles[c] / final_finishing_time);
+        writer_str(w, ", ");
+        writer_uint(w, result->core_migrations[c]);
+        writer_str(w, " processes migrated in\n");
+    }
+    writer_str(w, "\tTotal migrations: ");
+    writer_uint(w, result->total_migrations);
+    writer_char(w, '\n');
+} // End of the print core data function
+
+/**
+ * Prints how often the CPU changed hands, for the schedulers that preempt on arrival
+ */
+void printSwitchData(writer_t *w, const scheduler_result_t *result)
+{
+    writer_str(w, "Switch Data:\n\tContext switches: ");
+    writer_uint(w, result->total_context_switches);
+    writer_str(w, "\n\tPreemptions: ");
+    writer_uint(w, result->total_preemptions);
+    writer_char(w, '\n');
+} // End of the print switch data function
+
+/**
+ * Prints the CPU time run at every level of a multi-level feedback queue
+ */
+void printLevelData(writer_t *w, const scheduler_result_t *result)
+{
+    uint64_t total = 0;
+    for (uint32_t l = 0; l < result->num_levels; ++l)
+    {
+        total += result->level_cycles[l];
+    }
+
+    writer_str(w, "Level Data:\n");
+    for (uint32_t l = 0; l < result->num_levels; ++l)
+    {
+        writer_str(w, "\tLevel ");
+        writer_uint(w, l);
+        writer_str(w, ": ");
+        writer_uint(w, result->level_cycles[l]);
+        writer_str(w, " cycles run, residency ");
+        writer_double6(w, total ? (double)result->level_cycles[l] / total : 0.0);
+        writer_char(w, '\n');
+    }
+} // End of the print level data function
+
+/**
+ * Prints the CPU time every process got against the CPU time its tickets entitled it to, for the lottery and
+ * stride schedulers
+ * process_list The processes after the run, in array form
+ */
+void printShareData(writer_t *w, process_t process_list[], const scheduler_result_t *result)
+{
+    double total_error = 0.0;
+
+    writer_str(w, "Share Data:\n");
+    for (uint32_t i = 0; i < result->total_created_processes; ++i)
+    {
+        double entitled = process_list[i].entitled_time;
+        total_error += fabs(process_list[i].cpu_time - entitled);
+
+        writer_str(w, "\tProcess ");
+        writer_uint(w, process_list[i].id);
+        writer_str(w, ": ");
+        writer_uint(w, share_tickets(process_list[i].tickets));
+        writer_str(w, " tickets, CPU time ");
+        writer_uint(w, process_list[i].cpu_time);
+        writer_str(w, " of ");
+        writer_double6(w, entitled);
+        writer_str(w, " entitled\n");
+    }
+    writer_str(w, "\tAverage deviation from the entitled CPU time: ");
+    writer_double6(w, result->total_created_processes ? total_error / result->total_created_processes : 0.0);
+    writer_char(w, '\n');
+} // End of the print share data function
+
+#ifdef SCHED_PROFILE
+/**
+ * Prints the instrumentation of a run as one line of JSON, for the builds with SCHED_PROFILE (see profile.h)
+ */
+void printProfileData(writer_t *w, const char *scheduler, const scheduler_result_t *result)
 {
-    process_t *cpy = malloc(sizeof(process_t) * size);
-    memcpy(cpy, process_list, sizeof(process_t) * size);
+    const profile_t *p = &result->profile;
+    const char *names[] = {"cycles", "context_switches", "preemptions", "idle_cycles", "picks",
+                           "enqueues", "burst_draws", "events", "total_ns"};
+    uint64_t values[] = {result->current_cycle, result->total_context_switches, result->total_preemptions,
+                         p->idle_cycles, p->picks, p->enqueues, p->burst_draws, p->events, p->total_ns};
 
-    printf("\n\n*** %s ***:\n", scheduler);
-    printStart(cpy, size);
+    writer_str(w, "Profile: {\"scheduler\": \"");
+    writer_str(w, scheduler);
+    writer_char(w, '"');
+    for (uint32_t k = 0; k < sizeof(values) / sizeof(values[0]); ++k)
+    {
+        writer_str(w, ", \"");
+        writer_str(w, names[k]);
+        writer_str(w, "\": ");
+        writer_uint(w, values[k]);
+    }
+    writer_str(w, ", \"phase_ns\": {");
+    for (uint32_t k = 0; k < NUM_PHASES; ++k)
+    {
+        writer_str(w, k ? ", \"" : "\"");
+        writer_str(w, PROFILE_PHASE_NAMES[k]);
+        writer_str(w, "\": ");
+        writer_uint(w, p->phase_ns[k]);
+    }
+    writer_str(w, "}}\n");
+} // End of the print profile data function
+#endif
+
+/********************* SCHEDULER REGISTRY *********************/
+
+/* The tunables of the parameterised schedulers */
+typedef enum
+{
+    PARAM_QUANTUM = 0,     // Time quantum of RR, LOTTERY and STRIDE, and the quantum of the first level of MLFQ
+    PARAM_AGING = 1,       // Cycles waited per step of aging for PRI and PPRI, 0 disables aging
+    PARAM_CORES = 2,       // Simulated cores for FCFS, SJF and RR
+    PARAM_LEVELS = 3,      // Levels of MLFQ
+    PARAM_BOOST = 4,       // Cycles between two boosts of MLFQ, 0 disables boosts
+    PARAM_LATENCY = 5,     // Target latency of CFS
+    PARAM_GRANULARITY = 6, // Minimum granularity of CFS
+    NUM_PARAMS = 7
+} scheduler_param;
+
+const char *PARAM_NAMES[NUM_PARAMS] = {"quantum", "aging", "cores", "levels", "boost", "latency", "granularity"};
+const uint32_t PARAM_MIN[NUM_PARAMS] = {1, 0, 1, 1, 0, 1, 1};
+const uint32_t PARAM_MAX[NUM_PARAMS] = {UINT8_MAX, UINT32_MAX, MAX_CORES, MAX_LEVELS, UINT32_MAX, UINT16_MAX, UINT16_MAX};
+
+/* The settings a scheduler runs with */
+typedef struct
+{
+    uint32_t values[NUM_PARAMS];
+    bool event_driven;  // -e: use the event-driven engine instead of ticking every cycle
+    bool trace;         // -t: report the state of every process before every cycle (the single-core schedulers)
+    bool rr_preemptive; // -q: RR preempts at the end of the quantum instead of blocking after every cycle
+} scheduler_params_t;
 
-    scheduler_result_t result = f(cpy, size);
-    printFinal(cpy, result);
+// A scheduler run records its cycles in the trace log when given one, which every single-core scheduler does
+typedef scheduler_result_t (*scheduler_fn)(const sched_context_t *, process_t *, uint32_t, const scheduler_params_t *,
+                                           trace_log_t *);
 
-    printProcessSpecifics(cpy, result);
-    printSummaryData(cpy, result);
+scheduler_result_t run_fcfs(const sched_context_t *context, process_t *processes, uint32_t size,
+                            const scheduler_params_t *params, trace_log_t *trace)
+{
+    if (params->values[PARAM_CORES] > 1)
+    {
+        return fcfs_multicore(context, processes, size, params->values[PARAM_CORES]);
+    }
+    return params->event_driven ? fcfs_event(context, processes, size) : fcfs_traced(context, processes, size, trace);
 }
 
-/// The first number in the file is the total number of processes
-/// Panics if the file is not formatted correctly
-uint32_t read_process_amount(FILE *f)
+scheduler_result_t run_sjf(const sched_context_t *context, process_t *processes, uint32_t size,
+                           const scheduler_params_t *params, trace_log_t *trace)
 {
-    uint32_t total_num_of_process = 0;
-    assert(fscanf(f, "%u", &total_num_of_process) == 1);
-    return total_num_of_process;
+    if (params->values[PARAM_CORES] > 1)
+    {
+        return sjf_multicore(context, processes, size, params->values[PARAM_CORES]);
+    }
+    return params->event_driven ? sjf_event(context, processes, size) : sjf_traced(context, processes, size, trace);
 }
 
-/// Reads the processes from the file
-/// Panics if the file is not formatted correctly
-void read_processes(FILE *f, process_t *process_list, uint32_t total_num_of_process)
+scheduler_result_t run_rr(const sched_context_t *context, process_t *processes, uint32_t size,
+                          const scheduler_params_t *params, trace_log_t *trace)
 {
-    for (uint32_t i = 0; i < total_num_of_process; ++i)
+    uint8_t quantum = params->values[PARAM_QUANTUM];
+    if (params->values[PARAM_CORES] > 1)
     {
-        process_list[i] = (process_t){0};
-        int scanned = fscanf(f, " (%u %u %u %u)",
-                             &process_list[i].A,
-                             &process_list[i].B,
-                             &process_list[i].C,
+        return rr_multicore(context, processes, size, quantum, params->rr_preemptive, params->values[PARAM_CORES]);
+    }
+    return params->event_driven ? rr_event(context, processes, size, quantum, params->rr_preemptive)
+                                : rr_traced(context, processes, size, quantum, params->rr_preemptive, trace);
+}
+
+scheduler_result_t run_priority(const sched_context_t *context, process_t *processes, uint32_t size,
+                                const scheduler_params_t *params, trace_log_t *trace)
+{
+    return priority_traced(context, processes, size, false, params->values[PARAM_AGING], trace);
+}
+
+scheduler_result_t run_priority_preemptive(const sched_context_t *context, process_t *processes, uint32_t size,
+                                           const scheduler_params_t *params, trace_log_t *trace)
+{
+    return priority_traced(context, processes, size, true, params->values[PARAM_AGING], trace);
+}
+
+scheduler_result_t run_srtf(const sched_context_t *context, process_t *processes, uint32_t size,
+                            const scheduler_params_t *params, trace_log_t *trace)
+{
+    (void)params;
+    return srtf_traced(context, processes, size, trace);
+}
+
+scheduler_result_t run_mlfq(const sched_context_t *context, process_t *processes, uint32_t size,
+                            const scheduler_params_t *params, trace_log_t *trace)
+{
+    mlfq_config_t config = mlfq_config(params->values[PARAM_LEVELS], params->values[PARAM_QUANTUM],
+                                       params->values[PARAM_BOOST]);
+    return mlfq_traced(context, processes, size, &config, trace);
+}
 
-                             &process_list[i].M);
+scheduler_result_t run_cfs(const sched_context_t *context, process_t *processes, uint32_t size,
+                           const scheduler_params_t *params, trace_log_t *trace)
+{
+    cfs_config_t config = {.target_latency = params->values[PARAM_LATENCY],
+                           .min_granularity = params->values[PARAM_GRANULARITY]};
+    return cfs_traced(context, processes, size, &config, trace);
+}
+
+scheduler_result_t run_edf(const sched_context_t *context, process_t *processes, uint32_t size,
+                           const scheduler_params_t *params, trace_log_t *trace)
+{
+    (void)params;
+    return edf_traced(context, processes, size, trace);
+}
+
+scheduler_result_t run_lottery(const sched_context_t *context, process_t *processes, uint32_t size,
+                               const scheduler_params_t *params, trace_log_t *trace)
+{
+    return lottery_traced(context, processes, size, params->values[PARAM_QUANTUM], trace);
+}
+
+scheduler_result_t run_stride(const sched_context_t *context, process_t *processes, uint32_t size,
+                              const scheduler_params_t *params, trace_log_t *trace)
+{
+    return stride_traced(context, processes, size, params->values[PARAM_QUANTUM], trace);
+}
 
-        assert(scanned == 4);
-        process_list[i].id = i;
+/* A scheduler the runner reports on, in the order of the report */
+typedef struct
+{
+    const char *name;  // Name in the CSV of a sweep
+    const char *label; // Name in the report header
+    scheduler_fn run;
+    uint32_t params; // Bit p is set when the scheduler uses parameter p
+    bool switches;   // Whether the report includes the context switches and preemptions
+    bool fairness;   // Whether the report includes the fairness figures
+    bool shares;     // Whether the report includes the CPU time every process was entitled to
+} scheduler_entry_t;
+
+const scheduler_entry_t SCHEDULERS[] = {
+    {"FCFS", "FCFS", run_fcfs, 1 << PARAM_CORES},
+    {"SJF", "SJF", run_sjf, 1 << PARAM_CORES},
+    {"RR", "RR ", run_rr, 1 << PARAM_QUANTUM | 1 << PARAM_CORES},
+    {"PRI", "PRI", run_priority, 1 << PARAM_AGING},
+    {"PPRI", "PPRI", run_priority_preemptive, 1 << PARAM_AGING},
+    {"SRTF", "SRTF", run_srtf, 0, true},
+    {"MLFQ", "MLFQ", run_mlfq, 1 << PARAM_QUANTUM | 1 << PARAM_LEVELS | 1 << PARAM_BOOST, true},
+    {"CFS", "CFS", run_cfs, 1 << PARAM_LATENCY | 1 << PARAM_GRANULARITY, true, true},
+    {"EDF", "EDF", run_edf, 0, true},
+    {"LOTTERY", "LOTTERY", run_lottery, 1 << PARAM_QUANTUM, true, false, true},
+    {"STRIDE", "STRIDE", run_stride, 1 << PARAM_QUANTUM, true, false, true},
+};
+const uint32_t NUM_SCHEDULERS = sizeof(SCHEDULERS) / sizeof(SCHEDULERS[0]);
+
+/// @brief The parameters a scheduler uses with the given settings, RR only uses the quantum with -q
+uint32_t scheduler_params_used(const scheduler_entry_t *scheduler, const scheduler_params_t *params)
+{
+    if (scheduler->run == run_rr && !params->rr_preemptive)
+    {
+        return scheduler->params & ~(1u << PARAM_QUANTUM);
+    }
+    return scheduler->params;
+}
+
+/********************* RUNNER *********************/
+
+/* The processes read from one input file */
+typedef struct
+{
+    const char *file_name;
+    process_t *processes;
+    uint32_t size;
+} input_t;
+
+/* One scheduler with one setting on one input, the report is buffered until every run is done */
+typedef struct
+{
+    const input_t *input;
+    const scheduler_entry_t *scheduler;
+    scheduler_params_t params;
+    bool csv; // Whether to report a CSV row of the summary instead of the full report
+    char *report;
+    size_t report_length;
+} run_t;
+
+/**
+ * Runs a scheduler on a copy of the processes and prints the whole report to the writer
+ */
+void out(writer_t *w, const sched_context_t *context, const run_t *run)
+{
+    uint32_t size = run->input->size;
+    process_t *cpy = malloc(sizeof(process_t) * (size ? size : 1));
+    memcpy(cpy, run->input->processes, sizeof(process_t) * size);
+
+    writer_str(w, "\n\n*** ");
+    writer_str(w, run->scheduler->label);
+    writer_str(w, " ***:\n");
+    printStart(w, cpy, size);
+
+    trace_log_t trace;
+    if (run->params.trace)
+    {
+        trace_log_init(&trace, size);
+    }
+
+    scheduler_result_t result = run->scheduler->run(context, cpy, size, &run->params, run->params.trace ? &trace : NULL);
+    printFinal(w, cpy, &result);
+
+    if (run->params.trace)
+    {
+        if (trace.num_cycles)
+        {
+            writer_char(w, '\n');
+            trace_render(&trace, w);
+        }
+        trace_log_free(&trace);
+    }
+
+    printProcessSpecifics(w, cpy, &result);
+    printSummaryData(w, cpy, &result);
+    printLatencyData(w, &result);
+    if (result.num_cores > 1)
+    {
+        printCoreData(w, &result);
+    }
+    if (run->scheduler->switches)
+    {
+        printSwitchData(w, &result);
+    }
+    if (result.num_levels > 0)
+    {
+        printLevelData(w, &result);
     }
+    if (run->scheduler->fairness)
+    {
+        printFairnessData(w, cpy, &result);
+    }
+    if (run->scheduler->shares)
+    {
+        printShareData(w, cpy, &result);
+    }
+#ifdef SCHED_PROFILE
+    printProfileData(w, run->scheduler->name, &result);
+#endif
+
+    free(cpy);
 }
 
-scheduler_result_t _rr(process_t *processes, uint32_t size)
+/**
+ * Prints the CSV header matching out_csv()
+ */
+void printCsvHeader(writer_t *w)
 {
-    return rr(processes, size, 2);
+    writer_str(w, "input,scheduler");
+    for (uint32_t p = 0; p < NUM_PARAMS; ++p)
+    {
+        writer_char(w, ',');
+        writer_str(w, PARAM_NAMES[p]);
+    }
+    writer_str(w, ",finishing_time,cpu_utilisation,io_utilisation,throughput,average_turnaround_time,average_waiting_time,"
+                  "p99_turnaround_time,p99_waiting_time,p99_response_time\n");
+}
+
+/**
+ * Runs a scheduler on a copy of the processes and prints one CSV row of the summary to the writer.
+ * The parameters the scheduler does not use are left empty.
+ */
+void out_csv(writer_t *w, const sched_context_t *context, const run_t *run)
+{
+    uint32_t size = run->input->size;
+    process_t *cpy = malloc(sizeof(process_t) * (size ? size : 1));
+    memcpy(cpy, run->input->processes, sizeof(process_t) * size);
+
+    scheduler_result_t result = run->scheduler->run(context, cpy, size, &run->params, NULL);
+    summary_t summary = summarise(cpy, &result);
+
+    writer_str(w, run->input->file_name);
+    writer_char(w, ',');
+    writer_str(w, run->scheduler->name);
+    uint32_t used = scheduler_params_used(run->scheduler, &run->params);
+    for (uint32_t p = 0; p < NUM_PARAMS; ++p)
+    {
+        writer_char(w, ',');
+        if (used & 1 << p)
+        {
+            writer_uint(w, run->params.values[p]);
+        }
+    }
+
+    double figures[] = {summary.cpu_util, summary.io_util, summary.throughput, summary.avg_turnaround_time,
+                        summary.avg_waiting_time};
+    writer_char(w, ',');
+    writer_uint(w, summary.finishing_time);
+    for (uint32_t f = 0; f < sizeof(figures) / sizeof(figures[0]); ++f)
+    {
+        writer_char(w, ',');
+        writer_double6(w, figures[f]);
+    }
+
+    const histogram_t *tails[] = {&result.turnaround_times, &result.waiting_times, &result.response_times};
+    for (uint32_t f = 0; f < sizeof(tails) / sizeof(tails[0]); ++f)
+    {
+        writer_char(w, ',');
+        writer_uint(w, histogram_percentile(tails[f], 0.99));
+    }
+    writer_char(w, '\n');
+
+    free(cpy);
+}
+
+/* Runs shared by the worker threads, each worker claims the next run until none are left */
+typedef struct
+{
+    const sched_context_t *context; // Shared by every run, which only reads it
+    run_t *runs;
+    uint32_t num_runs;
+    atomic_uint next_run;
+} run_queue_t;
+
+void *run_worker(void *arg)
+{
+    run_queue_t *q = arg;
+    writer_t *w = malloc(sizeof(writer_t)); // Reused for every report of the worker
+    for (uint32_t i = atomic_fetch_add(&q->next_run, 1); i < q->num_runs; i = atomic_fetch_add(&q->next_run, 1))
+    {
+        run_t *run = &q->runs[i];
+
+        FILE *stream = open_memstream(&run->report, &run->report_length);
+        assert(stream != NULL);
+        writer_init(w, stream);
+        if (run->csv)
+        {
+            out_csv(w, q->context, run);
+        }
+        else
+        {
+            out(w, q->context, run);
+        }
+        writer_flush(w);
+        fclose(stream);
+    }
+    free(w);
+    return NULL;
+}
+
+/// Runs every run on up to num_threads threads, returning once all reports are written
+void run_all(const sched_context_t *context, run_t *runs, uint32_t num_runs, uint32_t num_threads)
+{
+    run_queue_t q = {.context = context, .runs = runs, .num_runs = num_runs};
+    atomic_init(&q.next_run, 0);
+
+    num_threads = num_threads < num_runs ? num_threads : num_runs;
+    pthread_t *threads = malloc(sizeof(pthread_t) * (num_threads ? num_threads : 1));
+    for (uint32_t t = 0; t < num_threads; ++t)
+    {
+        int created = pthread_create(&threads[t], NULL, run_worker, &q);
+        assert(created == 0);
+        (void)created;
+    }
+    for (uint32_t t = 0; t < num_threads; ++t)
+    {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+}
+
+/* A range of values of a parameter, first..last every step */
+typedef struct
+{
+    uint32_t first;
+    uint32_t last;
+    uint32_t step;
+    bool swept;
+} param_range_t;
+
+/// Parses a sweep of the form name=first:last[:step] into ranges
+/// @return whether the sweep is valid
+bool parse_sweep(const char *spec, param_range_t ranges[NUM_PARAMS])
+{
+    char name[16];
+    param_range_t range = {.step = 1, .swept = true};
+    int scanned = sscanf(spec, "%15[^=]=%u:%u:%u", name, &range.first, &range.last, &range.step);
+    if (scanned == 2)
+    {
+        range.last = range.first;
+    }
+    else if (scanned < 2)
+    {
+        return false;
+    }
+
+    for (uint32_t p = 0; p < NUM_PARAMS; ++p)
+    {
+        if (strcmp(name, PARAM_NAMES[p]) == 0)
+        {
+            if (range.first < PARAM_MIN[p] || range.last > PARAM_MAX[p] || range.first > range.last || range.step == 0)
+            {
+                return false;
+            }
+            ranges[p] = range;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Appends the runs of a scheduler over every combination of the swept parameters it uses
+/// @return the number of runs appended
+uint32_t add_sweep_runs(run_t *runs, const input_t *input, const scheduler_entry_t *scheduler,
+                        const scheduler_params_t *defaults, const param_range_t ranges[NUM_PARAMS])
+{
+    scheduler_params_t params = *defaults;
+    uint32_t used = scheduler_params_used(scheduler, defaults);
+    bool sweeps_any = false;
+    for (uint32_t p = 0; p < NUM_PARAMS; ++p)
+    {
+        if (ranges[p].swept && used & 1 << p)
+        {
+            params.values[p] = ranges[p].first;
+            sweeps_any = true;
+        }
+    }
+    if (!sweeps_any)
+    {
+        return 0;
+    }
+
+    // Counts through the grid like an odometer, the last parameter moving fastest
+    uint32_t num_runs = 0;
+    for (;;)
+    {
+        if (runs != NULL)
+        {
+            runs[num_runs] = (run_t){.input = input, .scheduler = scheduler, .params = params, .csv = true};
+        }
+        num_runs++;
+
+        int p = NUM_PARAMS - 1;
+        for (; p >= 0; --p)
+        {
+            if (!ranges[p].swept || !(used & 1 << p))
+            {
+                continue;
+            }
+            if (ranges[p].last - params.values[p] >= ranges[p].step)
+            {
+                params.values[p] += ranges[p].step;
+                break;
+            }
+            params.values[p] = ranges[p].first;
+        }
+        if (p < 0)
+        {
+            return num_runs;
+        }
+    }
 }
 
 int main(int argc, char *argv[])
 {
-    // #region OPEN_FILE
-    if (argc < 2)
+    // #region PARSE_ARGS
+    scheduler_params_t defaults = {
+        .values = {[PARAM_QUANTUM] = 2, [PARAM_AGING] = 8, [PARAM_CORES] = 1, [PARAM_LEVELS] = 3, [PARAM_BOOST] = 100,
+                   [PARAM_LATENCY] = 24, [PARAM_GRANULARITY] = 3}};
+    param_range_t ranges[NUM_PARAMS] = {0};           // -s: the parameters swept
+    bool sweep = false;                               // Whether to report a CSV of every swept setting
+    long num_threads = sysconf(_SC_NPROCESSORS_ONLN); // -j: the number of schedulers run at the same time
+
+    int opt;
+    while ((opt = getopt(argc, argv, "etqk:j:s:")) != -1)
     {
-        printf("Please provide a file name.\n");
+        switch (opt)
+        {
+        case 'e':
+            defaults.event_driven = true;
+            break;
+        case 't':
+            defaults.trace = true;
+            break;
+        case 'q':
+            defaults.rr_preemptive = true;
+            break;
+        case 'k':
+            defaults.values[PARAM_CORES] = strtoul(optarg, NULL, 10);
+            if (defaults.values[PARAM_CORES] >= 1 && defaults.values[PARAM_CORES] <= MAX_CORES)
+            {
+                break;
+            }
+            printf("The number of cores must be between 1 and %u.\n", MAX_CORES);
+            return 1;
+        case 'j':
+            num_threads = strtol(optarg, NULL, 10);
+            if (num_threads >= 1)
+            {
+                break;
+            }
+            printf("The number of threads must be at least 1.\n");
+            return 1;
+        case 's':
+            if (parse_sweep(optarg, ranges))
+            {
+                sweep = true;
+                break;
+            }
+            printf("Invalid sweep %s, expected quantum, aging, cores, levels, boost, latency or granularity=first:last[:step] within bounds.\n", optarg);
+            return 1;
+        default:
+            printf("Usage: %s [-e] [-t] [-q] [-k cores] [-j threads] [-s param=first:last[:step]]... <file>...\n", argv[0]);
+            return 1;
+        }
+    }
+    if (defaults.trace && (defaults.event_driven || defaults.values[PARAM_CORES] > 1 || sweep))
+    {
+        printf("The trace needs the default engine on one core, without a sweep.\n");
         return 1;
     }
+    num_threads = num_threads >= 1 ? num_threads : 1;
+    // #endregion PARSE_ARGS
 
-    FILE *f = fopen(argv[1], "r");
-    if (f == NULL)
+    // #region READ_PROCESSES
+    if (optind >= argc)
     {
-        printf("Failed to open the file.\n");
+        printf("Please provide a file name.\n");
         return 1;
     }
-    // #endregion OPEN_FILE
 
-    // #region READ_PROCESSES
-    uint32_t total_num_of_process = read_process_amount(f);
-    process_t process_list[total_num_of_process];
-    read_processes(f, process_list, total_num_of_process);
+    uint32_t num_inputs = argc - optind;
+    input_t *inputs = malloc(sizeof(input_t) * num_inputs);
+    for (uint32_t i = 0; i < num_inputs; ++i)
+    {
+        inputs[i].file_name = argv[optind + i];
+
+        load_error_t err;
+        if (!load_processes_file(inputs[i].file_name, &inputs[i].processes, &inputs[i].size, &err))
+        {
+            if (err.line)
+            {
+                printf("%s:%u:%u: %s\n", inputs[i].file_name, err.line, err.column, err.message);
+            }
+            else
+            {
+                printf("%s\n", err.message);
+            }
+            return 1;
+        }
+    }
     // #endregion READ_PROCESSES
 
+    // #region READ_RANDOM_NUMBERS
+    // Every run draws its bursts from the one table, which no run writes
+    random_table_t random;
+    if (!random_table_load(&random, RANDOM_NUMBER_FILE_NAME, true, NULL))
+    {
+        printf("Could not read the random numbers from %s.\n", RANDOM_NUMBER_FILE_NAME);
+        return 1;
+    }
+    sched_context_t context = {.random = &random};
+    // #endregion READ_RANDOM_NUMBERS
+
     // #region SCHEDULERS
-    out(process_list, total_num_of_process, "FCFS", fcfs);
-    out(process_list, total_num_of_process, "SJF", sjf);
-    out(process_list, total_num_of_process, "RR ", _rr);
+    // Every scheduler on every input, or in a sweep every swept setting of the schedulers using it
+    uint32_t num_runs = 0;
+    run_t *runs = NULL;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        num_runs = 0;
+        for (uint32_t i = 0; i < num_inputs; ++i)
+        {
+            for (uint32_t s = 0; s < NUM_SCHEDULERS; ++s)
+            {
+                if (sweep)
+                {
+                    num_runs += add_sweep_runs(runs ? runs + num_runs : NULL, &inputs[i], &SCHEDULERS[s], &defaults, ranges);
+                }
+                else
+                {
+                    if (runs != NULL)
+                    {
+                        runs[num_runs] = (run_t){.input = &inputs[i], .scheduler = &SCHEDULERS[s], .params = defaults};
+                    }
+                    num_runs++;
+                }
+            }
+        }
+        runs = runs ? runs : calloc(num_runs ? num_runs : 1, sizeof(run_t));
+    }
+
+    run_all(&context, runs, num_runs, num_threads);
     // #endregion SCHEDULERS
 
-    fclose(f);
+    // #region REPORT
+    // Reports come out in input order then scheduler order, whichever run finished first
+    writer_t *w = malloc(sizeof(writer_t));
+    writer_init(w, stdout);
+    if (sweep)
+    {
+        printCsvHeader(w);
+    }
+    for (uint32_t i = 0; i < num_runs; ++i)
+    {
+        if (!sweep && num_inputs > 1 && (i == 0 || runs[i].input != runs[i - 1].input))
+        {
+            writer_str(w, i ? "\n==> " : "==> ");
+            writer_str(w, runs[i].input->file_name);
+            writer_str(w, " <==\n");
+        }
+        writer_bytes(w, runs[i].report, runs[i].report_length);
+        free(runs[i].report);
+    }
+    writer_flush(w);
+    free(w);
+    // #endregion REPORT
+
+    for (uint32_t i = 0; i < num_inputs; ++i)
+    {
+        free(inputs[i].processes);
+    }
+    free(inputs);
+    free(runs);
+    random_table_free(&random);
     return 0;
-}
\ No newline at end of file
+}
@@ -1,349 +1,1072 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
-#include "random.h"
+#include <string.h>
+#include <assert.h>
+#include "process.h"
+#include "process_table.h"
+#include "ready_queue.h"
+#include "rb_tree.h"
+#include "fenwick.h"
+#include "timer_wheel.h"
+#include "engine.h"
+
+/*
+ * The single-core schedulers, each a policy of the tick engine (see engine.h).
+ *
+ * The _traced versions of fcfs(), sjf(), srtf(), rr(), priority(), mlfq(), cfs(), edf(), lottery() and stride()
+ * also record every cycle in a trace log (see trace.h).
+ *
+ * Every scheduler first takes the context it runs in (see context.h): the table its CPU bursts are drawn from
+ * and the allocator its memory comes from.
+ */
+
+/********************* FCFS *********************/
 
-typedef enum
+/// @brief The next READY process after the one that left the CPU, once the CPU is free
+static inline uint32_t fcfs_pick(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running)
 {
-    UNSTARTED = 0,
-    READY = 1,
-    RUNNING = 2,
-    BLOCKED = 3,
-    TERMINATED = 4
-} process_status;
+    (void)state;
+    return num_running ? NO_PROCESS : process_table_next_ready(t, scan_from);
+}
+
+static const scheduler_policy_t FCFS_POLICY = {.pick = fcfs_pick};
 
-/* Defines a job struct */
-typedef struct _process
+/// @brief  Non-premptive First-Come-First-Serve (FCFS) Scheduler
+///
+/// When the CPU frees up, the next READY process after the one that left (wrapping around) runs next.
+/// @param trace the log to record every cycle in, or NULL
+static inline scheduler_result_t fcfs_traced(const sched_context_t *context, process_t *processes,
+                                             uint32_t total_num_of_process, trace_log_t *trace)
 {
-    uint32_t A;  // A: Arrival time of the process
-    uint32_t B;  // B: Upper Bound of CPU burst times of the given random integer list
-    uint32_t C;  // C: Total CPU time required
-    uint32_t M;  // M: Multiplier of CPU burst time
-    uint32_t id; // The process ID given upon input read
+    return engine_run(context, processes, total_num_of_process, &FCFS_POLICY, NULL, trace);
+}
 
-    uint8_t status; // 0 is unstarted, 1 is ready, 2 is running, 3 is blocked, 4 is terminated
+/// @brief fcfs_traced() without a trace
+static inline scheduler_result_t fcfs(const sched_context_t *context, process_t *processes,
+                                      uint32_t total_num_of_process)
+{
+    return fcfs_traced(context, processes, total_num_of_process, NULL);
+}
 
-    int32_t finished_time; // The cycle when the the process finishes (initially -1)
-    uint32_t cpu_time;     // The amount of time the process has already run (time in running state)
-    uint32_t blocked_time; // The amount of time the process has been IO blocked (time in blocked state)
-    uint32_t waiting_time; // The amount of time spent waiting to be run (time in ready state)
+/********************* SJF *********************/
 
-    uint32_t io_burst;  // The amount of time until the process finishes being blocked
-    uint32_t cpu_burst; // The CPU availability of the process (has to be > 1 to move to running)
+static inline void sjf_enqueue(void *state, process_table_t *t, uint32_t i)
+{
+    ready_queue_push(state, i, t->C[i] - t->cpu_time[i]);
+}
 
-    int32_t quantum; // Used for schedulers that utilise pre-emption
+/// @brief The READY process with the least CPU time left, every cycle even while others run
+static inline uint32_t sjf_pick(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running)
+{
+    (void)t, (void)scan_from, (void)num_running;
+    return ready_queue_empty(state) ? NO_PROCESS : ready_queue_pop(state);
+}
 
-    bool is_first_run; // Used to check when to calculate the CPU burst when it hits running mode
-} process_t;
+static const scheduler_policy_t SJF_POLICY = {.enqueue = sjf_enqueue, .pick = sjf_pick};
 
-int cmpr_process_a(const void *a, const void *b)
+/// @brief Non-premptive Shortest Job First (SJF) Scheduler
+///
+/// READY processes are kept in a ready queue keyed on their remaining CPU time, so picking the
+/// shortest job is O(log N) instead of comparing every READY process each cycle.
+/// @param trace the log to record every cycle in, or NULL
+static inline scheduler_result_t sjf_traced(const sched_context_t *context, process_t *processes,
+                                            uint32_t total_num_of_process, trace_log_t *trace)
 {
-    process_t *pa = (process_t *)a;
-    process_t *pb = (process_t *)b;
+    ready_queue_t ready; // READY processes ordered by remaining CPU time
+    ready_queue_init(&ready, total_num_of_process, &context->allocator);
+
+    scheduler_result_t r = engine_run(context, processes, total_num_of_process, &SJF_POLICY, &ready, trace);
 
-    return pa->A - pb->A;
+    ready_queue_free(&ready);
+    return r;
 }
 
-typedef struct
+/// @brief sjf_traced() without a trace
+static inline scheduler_result_t sjf(const sched_context_t *context, process_t *processes,
+                                     uint32_t total_num_of_process)
+{
+    return sjf_traced(context, processes, total_num_of_process, NULL);
+}
+
+/********************* SRTF *********************/
+
+/// @brief Preempts the running process as soon as a READY one has strictly less CPU time left, which only
+/// happens right after an arrival or a wake-up since the running process only gets shorter
+static inline bool srtf_preempt(void *state, process_table_t *t, uint32_t i)
 {
-    uint32_t current_cycle;                        // The current cycle that each process is on
-    uint32_t total_created_processes;              // The total number of processes constructed
-    uint32_t total_started_processes;              // The total number of processes that have started being simulated
-    uint32_t total_finished_processes;             // The total number of processes that have finished running
-    uint32_t total_number_of_cycles_spent_blocked; // The total cycles in the blocked state
-} scheduler_result_t;
+    if (ready_queue_empty(state))
+    {
+        return false;
+    }
+    uint32_t shortest = ready_queue_peek(state);
+    return t->C[shortest] - t->cpu_time[shortest] < t->C[i] - t->cpu_time[i];
+}
 
-/// @brief Calculates the CPU burst time and the IO burst time for a given process
-static void set_bursts(process_t *p)
+/// @brief The READY process with the least CPU time left, once the CPU is free
+static inline uint32_t srtf_pick(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running)
 {
-    p->cpu_burst = randomOS(p->B, p->id, NULL);
-    p->io_burst = p->cpu_burst * p->M;
+    (void)t, (void)scan_from;
+    return num_running || ready_queue_empty(state) ? NO_PROCESS : ready_queue_pop(state);
 }
 
-/// @brief Iterate through an array in a circular fashion, ie the tail overflows back to the head.
+static const scheduler_policy_t SRTF_POLICY = {.enqueue = sjf_enqueue, .preempt = srtf_preempt, .pick = srtf_pick};
+
+/// @brief Shortest Remaining Time First (SRTF) Scheduler, preemptive SJF
 ///
-/// Starts from location memory_offset
-#define circular_iterator(memory_head, memory_offset, i, total_memory) &memory_head[((memory_offset - memory_head) + i) % total_memory]
+/// The READY process with the least CPU time left runs, and takes over the CPU when it has less left than
+/// the running process. The ready queue is a min-heap, so the preemption check is a peek at its top.
+/// @param trace the log to record every cycle in, or NULL
+static inline scheduler_result_t srtf_traced(const sched_context_t *context, process_t *processes,
+                                             uint32_t total_num_of_process, trace_log_t *trace)
+{
+    ready_queue_t ready; // READY processes ordered by remaining CPU time
+    ready_queue_init(&ready, total_num_of_process, &context->allocator);
 
-/// @brief  Non-premptive First-Come-First-Serve (FCFS) Scheduler
-scheduler_result_t fcfs(process_t *processes, uint32_t total_num_of_process)
+    scheduler_result_t r = engine_run(context, processes, total_num_of_process, &SRTF_POLICY, &ready, trace);
+
+    ready_queue_free(&ready);
+    return r;
+}
+
+/// @brief srtf_traced() without a trace
+static inline scheduler_result_t srtf(const sched_context_t *context, process_t *processes,
+                                      uint32_t total_num_of_process)
 {
-    qsort(processes, total_num_of_process, sizeof(process_t), cmpr_process_a);
+    return srtf_traced(context, processes, total_num_of_process, NULL);
+}
 
-    scheduler_result_t r = {0}; // Result of the scheduler
-    process_t *rp = NULL;       // Running process
-    process_t *p = NULL;        // Process
+/********************* RR *********************/
 
-    while (r.total_finished_processes < total_num_of_process)
+/* The state of the RR policy */
+typedef struct
+{
+    uint8_t quantum;
+    bool preemptive;
+} rr_state_t;
+
+/// @brief Without quantum preemption a process blocks after every cycle it runs, for the I/O of its whole
+/// CPU burst, and draws a new burst when dispatched again
+static inline void rr_tick(void *state, process_table_t *t, uint32_t i)
+{
+    if (((rr_state_t *)state)->preemptive)
     {
-        const process_t *mo = rp == NULL ? processes : rp;
-        for (int i = 0; i < total_num_of_process; i++)
-        {
-            p = circular_iterator(processes, mo, i, total_num_of_process);
+        t->quantum[i]--;
+    }
+    else if (t->status[i] == RUNNING)
+    {
+        t->cpu_burst[i] = 0;
+        t->status[i] = BLOCKED;
+    }
+}
 
-            // Terminated
-            if (p->status == TERMINATED)
-            {
-                continue;
-            }
+/// @brief Once the quantum is used up the process makes way for the next READY one, if any,
+/// or starts a new quantum
+static inline bool rr_preempt(void *state, process_table_t *t, uint32_t i)
+{
+    if (t->quantum[i] > 0)
+    {
+        return false;
+    }
+    if (process_table_next_ready(t, 0) != NO_PROCESS)
+    {
+        return true;
+    }
+    t->quantum[i] = ((rr_state_t *)state)->quantum;
+    return false;
+}
 
-            // Blocked
-            if (p->status == BLOCKED)
-            {
-                p->blocked_time++;
-                p->io_burst--;
+static inline uint32_t rr_pick(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running)
+{
+    uint32_t i = fcfs_pick(state, t, scan_from, num_running);
+    if (i != NO_PROCESS)
+    {
+        t->quantum[i] = ((rr_state_t *)state)->quantum;
+    }
+    return i;
+}
 
-                // Blocked -> Ready
-                p->status = p->io_burst ? BLOCKED : READY;
+static const scheduler_policy_t RR_POLICY = {.tick = rr_tick, .preempt = rr_preempt, .pick = rr_pick};
 
-                r.total_number_of_cycles_spent_blocked++;
-            }
+/// @brief Round Robin (RR) Scheduler
+///
+/// The READY processes take turns in a circular order. By default a process runs for one cycle and then
+/// blocks for the I/O of its whole CPU burst, whatever the quantum. With quantum preemption it runs for at
+/// most `quantum` cycles of its CPU burst instead, then goes back to READY with the rest of the burst if
+/// another process is READY, and the next READY process after it runs next.
+/// @param quantum the time quantum for the scheduler, at least 1
+/// @param preemptive whether to preempt at the end of the quantum rather than block after every cycle
+/// @param trace the log to record every cycle in, or NULL
+static inline scheduler_result_t rr_traced(const sched_context_t *context, process_t *processes,
+                                           uint32_t total_num_of_process, uint8_t quantum, bool preemptive,
+                                           trace_log_t *trace)
+{
+    rr_state_t state = {.quantum = quantum, .preemptive = preemptive};
+    return engine_run(context, processes, total_num_of_process, &RR_POLICY, &state, trace);
+}
 
-            // Unstarted -> Ready
-            else if (p->status == UNSTARTED && p->A == r.current_cycle)
-            {
-                p->cpu_time = 0;
-                p->blocked_time = 0;
-                p->waiting_time = 0;
-                p->is_first_run = true;
+/// @brief rr_traced() without a trace
+static inline scheduler_result_t rr(const sched_context_t *context, process_t *processes, uint32_t total_num_of_process,
+                                    uint8_t quantum, bool preemptive)
+{
+    return rr_traced(context, processes, total_num_of_process, quantum, preemptive, NULL);
+}
 
-                p->status = READY;
+/********************* PRIORITY *********************/
 
-                r.total_created_processes++;
-            }
+/* The state of the Priority policies */
+typedef struct
+{
+    ready_queue_t ready; // READY processes ordered by effective priority
+    timer_wheel_t aging; // The cycle every READY process that can still age next ages on
+    uint64_t cycle;      // The cycle the age hook runs on next
+    bool preemptive;
+    uint32_t aging_interval;
+} priority_state_t;
 
-            // Ready
-            if (p->status == READY)
-            {
-                // Ready -> Running
-                if (rp == NULL)
-                {
-                    set_bursts(p);
-                    p->status = RUNNING;
-                    rp = p;
-                }
-                else
-                {
-                    p->waiting_time++;
-                }
-            }
+/// @brief Queues a READY process and sets when it first ages: after aging_interval runs of the age hook, the
+/// first being this cycle's unless it already ran, as it has for a preempted process
+static inline void priority_enqueue(void *state, process_table_t *t, uint32_t i)
+{
+    priority_state_t *s = state;
+    ready_queue_push(&s->ready, i, t->effective_priority[i]);
+    if (s->aging_interval && t->effective_priority[i] > 0)
+    {
+        timer_wheel_insert(&s->aging, i, s->cycle + s->aging_interval - 1);
+    }
+}
 
-            // Running
-            else if (p->status == RUNNING)
+/// @brief Lowers the effective priority of every READY process that waited another aging_interval cycles
+///
+/// Only the processes due this cycle are visited, popped from the timer wheel, so aging costs nothing for the
+/// cycles in between and a process stops aging at priority 0.
+static inline void priority_age(void *state, process_table_t *t)
+{
+    priority_state_t *s = state;
+    if (s->aging_interval && timer_wheel_next(&s->aging, s->cycle) == s->cycle)
+    {
+        uint32_t i;
+        while (timer_wheel_pop(&s->aging, s->cycle, &i))
+        {
+            t->effective_priority[i]--;
+            ready_queue_decrease_key(&s->ready, i, t->effective_priority[i]);
+            if (t->effective_priority[i] > 0)
             {
-                p->cpu_time++;
-                p->cpu_burst--;
-                r.total_started_processes += p->is_first_run;
-                p->is_first_run = false;
-
-                // Running -> Terminate
-                if (p->cpu_time >= p->C)
-                {
-                    p->status = TERMINATED;
-                    p->finished_time = r.current_cycle;
-                    rp = NULL;
-
-                    r.total_finished_processes++;
-                }
-
-                // Running -> Block
-                else if (p->cpu_burst <= 0)
-                {
-                    rp = NULL;
-                    p->status = BLOCKED;
-                }
+                timer_wheel_insert(&s->aging, i, s->cycle + s->aging_interval);
             }
         }
+    }
+    s->cycle++;
+}
 
-        r.current_cycle++;
+/// @brief Preemptive only: a READY process with a better effective priority takes over the CPU
+static inline bool priority_preempt(void *state, process_table_t *t, uint32_t i)
+{
+    priority_state_t *s = state;
+    return s->preemptive && !ready_queue_empty(&s->ready) &&
+           t->effective_priority[ready_queue_peek(&s->ready)] < t->effective_priority[i];
+}
+
+/// @brief The READY process with the best effective priority, which is reset to its priority, once the CPU is free
+static inline uint32_t priority_pick(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running)
+{
+    (void)scan_from;
+    priority_state_t *s = state;
+    if (num_running || ready_queue_empty(&s->ready))
+    {
+        return NO_PROCESS;
     }
+
+    uint32_t i = ready_queue_pop(&s->ready);
+    timer_wheel_cancel(&s->aging, i);
+    t->effective_priority[i] = t->priority[i];
+    return i;
+}
+
+static const scheduler_policy_t PRIORITY_POLICY = {
+    .enqueue = priority_enqueue,
+    .age = priority_age,
+    .preempt = priority_preempt,
+    .pick = priority_pick,
+};
+
+/// @brief Priority Scheduler, the READY process with the lowest priority value runs next
+///
+/// A READY process has its effective priority lowered by one every aging_interval cycles it waits, so low
+/// priority processes are not starved. Aging updates the ready queue with a decrease-key rather than rebuilding it,
+/// and only touches the processes due to age, which wait in a timer wheel keyed by the cycle they next age on.
+/// @param preemptive whether a READY process with a better effective priority preempts the running process
+/// @param aging_interval the cycles waited per step of aging, 0 disables aging
+/// @param trace the log to record every cycle in, or NULL
+static inline scheduler_result_t priority_traced(const sched_context_t *context, process_t *processes,
+                                                 uint32_t total_num_of_process,
+                                                 bool preemptive, uint32_t aging_interval, trace_log_t *trace)
+{
+    priority_state_t state = {.preemptive = preemptive, .aging_interval = aging_interval};
+    ready_queue_init(&state.ready, total_num_of_process, &context->allocator);
+    timer_wheel_init(&state.aging, total_num_of_process, 0, &context->allocator);
+
+    scheduler_result_t r = engine_run(context, processes, total_num_of_process, &PRIORITY_POLICY, &state, trace);
+
+    ready_queue_free(&state.ready);
+    timer_wheel_free(&state.aging);
     return r;
 }
 
-/// @brief Non-premptive Shortest Job First (SJF) Scheduler
-scheduler_result_t sjf(process_t *processes, uint32_t total_num_of_process)
+/// @brief priority_traced() without a trace
+static inline scheduler_result_t priority(const sched_context_t *context, process_t *processes,
+                                          uint32_t total_num_of_process, bool preemptive, uint32_t aging_interval)
 {
-    qsort(processes, total_num_of_process, sizeof(process_t), cmpr_process_a);
+    return priority_traced(context, processes, total_num_of_process, preemptive, aging_interval, NULL);
+}
+
+/********************* MLFQ *********************/
 
-    scheduler_result_t r = {0}; // Result of the scheduler
-    process_t *p = NULL;
+_Static_assert(MAX_LEVELS <= LEVEL_QUEUE_MAX_LEVELS, "every MLFQ level needs a bit of the level bitmap");
+
+/* The levels of a multi-level feedback queue */
+typedef struct
+{
+    uint32_t num_levels;           // 1 .. MAX_LEVELS, level 0 runs first
+    uint32_t quantum[MAX_LEVELS];  // The time slice of each level, at least 1
+    uint32_t boost_interval;       // Cycles between two boosts of every process to level 0, 0 disables boosts
+} mlfq_config_t;
 
-    while (r.total_finished_processes < total_num_of_process)
+/// @brief The usual configuration: the quantum doubles from one level to the next
+/// @param quantum the quantum of level 0, at least 1
+static inline mlfq_config_t mlfq_config(uint32_t num_levels, uint32_t quantum, uint32_t boost_interval)
+{
+    mlfq_config_t config = {.num_levels = num_levels, .boost_interval = boost_interval};
+    for (uint32_t l = 0; l < num_levels; l++)
     {
-        process_t *sj = NULL; // Shortest job
+        config.quantum[l] = quantum << l;
+    }
+    return config;
+}
+
+/* The state of the MLFQ policy */
+typedef struct
+{
+    level_queue_t ready; // READY processes on their level
+    const mlfq_config_t *config;
 
-        for (int i = 0; i < total_num_of_process; i++)
+    // A process is on level[i] if it has not been boosted since, that is if epoch[i] is the number of
+    // boosts so far, and on level 0 otherwise. A boost is then O(levels) however many processes there are.
+    uint8_t *level;
+    uint32_t *epoch;
+    uint32_t boosts;
+    uint32_t since_boost; // Cycles since the last boost
+
+    uint32_t level_cycles[MAX_LEVELS];
+} mlfq_state_t;
+
+static inline uint32_t mlfq_level(const mlfq_state_t *s, uint32_t i)
+{
+    return s->epoch[i] == s->boosts ? s->level[i] : 0;
+}
+
+static inline void mlfq_set_level(mlfq_state_t *s, uint32_t i, uint32_t level)
+{
+    s->level[i] = (uint8_t)level;
+    s->epoch[i] = s->boosts;
+}
+
+/// @brief Queues a process at the back of its level. A process with no CPU burst left starts a new time
+/// slice when dispatched, and moves up a level if it is back from I/O.
+static inline void mlfq_enqueue(void *state, process_table_t *t, uint32_t i)
+{
+    mlfq_state_t *s = state;
+    uint32_t level = mlfq_level(s, i);
+    if (t->cpu_burst[i] == 0)
+    {
+        t->quantum[i] = 0;
+        if (t->cpu_time[i] > 0 && level > 0)
         {
-            p = &processes[i];
+            mlfq_set_level(s, i, --level);
+        }
+    }
+    level_queue_push(&s->ready, level, i);
+}
 
-            // Terminated
-            if (p->status == TERMINATED)
-            {
-                continue;
-            }
+/// @brief Moves every process to level 0 every boost_interval cycles, so long jobs are not starved
+static inline void mlfq_age(void *state, process_table_t *t)
+{
+    (void)t;
+    mlfq_state_t *s = state;
+    if (s->config->boost_interval && ++s->since_boost >= s->config->boost_interval)
+    {
+        s->since_boost = 0;
+        s->boosts++;
+        level_queue_merge_to_top(&s->ready);
+    }
+}
 
-            // Blocked
-            if (p->status == BLOCKED)
-            {
-                p->blocked_time++;
-                p->io_burst--;
+static inline void mlfq_tick(void *state, process_table_t *t, uint32_t i)
+{
+    mlfq_state_t *s = state;
+    t->quantum[i]--;
+    s->level_cycles[mlfq_level(s, i)]++;
+}
 
-                // Blocked -> Ready
-                p->status = p->io_burst ? BLOCKED : READY;
+/// @brief A process that used up its time slice moves down a level and makes way for any READY process on
+/// the same level or above, or else starts the time slice of its new level. Before that, a READY process on
+/// a better level takes over the CPU and the process keeps the rest of its time slice.
+static inline bool mlfq_preempt(void *state, process_table_t *t, uint32_t i)
+{
+    mlfq_state_t *s = state;
+    uint32_t level = mlfq_level(s, i);
+    bool waiting = !level_queue_empty(&s->ready);
 
-                r.total_number_of_cycles_spent_blocked++;
-            }
+    if (t->quantum[i] > 0)
+    {
+        return waiting && level_queue_first_level(&s->ready) < level;
+    }
 
-            // Unstarted -> Ready
-            else if (p->status == UNSTARTED && p->A == r.current_cycle)
-            {
-                p->cpu_time = 0;
-                p->blocked_time = 0;
-                p->waiting_time = 0;
-                p->is_first_run = true;
+    if (level + 1 < s->config->num_levels)
+    {
+        mlfq_set_level(s, i, ++level);
+    }
+    if (waiting && level_queue_first_level(&s->ready) <= level)
+    {
+        return true;
+    }
+    t->quantum[i] = s->config->quantum[level];
+    return false;
+}
 
-                p->status = READY;
+/// @brief The first READY process of the best level, once the CPU is free
+static inline uint32_t mlfq_pick(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running)
+{
+    (void)scan_from;
+    mlfq_state_t *s = state;
+    if (num_running || level_queue_empty(&s->ready))
+    {
+        return NO_PROCESS;
+    }
 
-                r.total_created_processes++;
-            }
+    uint32_t i = level_queue_pop(&s->ready);
+    if (t->quantum[i] == 0)
+    {
+        t->quantum[i] = s->config->quantum[mlfq_level(s, i)];
+    }
+    return i;
+}
 
-            // Ready
-            if (p->status == READY)
-            {
-                sj = sj == NULL ? p : ((p->C - p->cpu_time) < (sj->C - sj->cpu_time) ? p : sj);
-                p->waiting_time++;
-            }
+static const scheduler_policy_t MLFQ_POLICY = {
+    .enqueue = mlfq_enqueue,
+    .age = mlfq_age,
+    .tick = mlfq_tick,
+    .preempt = mlfq_preempt,
+    .pick = mlfq_pick,
+};
 
-            // Running
-            else if (p->status == RUNNING)
-            {
-                p->cpu_time++;
-                p->cpu_burst--;
-                r.total_started_processes += p->is_first_run;
-                p->is_first_run = false;
-
-                // Running -> Terminate
-                if (p->cpu_time >= p->C)
-                {
-                    p->status = TERMINATED;
-                    p->finished_time = r.current_cycle;
-
-                    r.total_finished_processes++;
-                }
-
-                // Running -> Block
-                else if (p->cpu_burst <= 0)
-                {
-                    p->status = BLOCKED;
-                }
-            }
-        }
+/// @brief Multi-Level Feedback Queue (MLFQ) Scheduler
+///
+/// Processes arrive on level 0 and the first READY process of the best level runs, for at most the quantum
+/// of its level. Using up the quantum moves a process down a level, so CPU bound processes sink to the long
+/// time slices of the lower levels, while finishing an I/O burst moves it up a level, so I/O bound processes
+/// stay on top. Every boost_interval cycles every process goes back to level 0. Picking a process is O(1).
+/// The result reports the cycles run at each level.
+/// @param config the levels, see mlfq_config()
+/// @param trace the log to record every cycle in, or NULL
+static inline scheduler_result_t mlfq_traced(const sched_context_t *context, process_t *processes,
+                                             uint32_t total_num_of_process, const mlfq_config_t *config,
+                                             trace_log_t *trace)
+{
+    assert(config->num_levels >= 1 && config->num_levels <= MAX_LEVELS);
+
+    uint32_t n = total_num_of_process ? total_num_of_process : 1;
+    mlfq_state_t state = {.config = config};
+    level_queue_init(&state.ready, total_num_of_process, &context->allocator);
+    state.level = sched_calloc(&context->allocator, n, sizeof(uint8_t));
+    state.epoch = sched_calloc(&context->allocator, n, sizeof(uint32_t));
+
+    scheduler_result_t r = engine_run(context, processes, total_num_of_process, &MLFQ_POLICY, &state, trace);
+    r.num_levels = config->num_levels;
+    memcpy(r.level_cycles, state.level_cycles, sizeof(r.level_cycles));
+
+    level_queue_free(&state.ready);
+    sched_free(&context->allocator, state.level);
+    sched_free(&context->allocator, state.epoch);
+    return r;
+}
+
+/// @brief mlfq_traced() without a trace
+static inline scheduler_result_t mlfq(const sched_context_t *context, process_t *processes,
+                                      uint32_t total_num_of_process, const mlfq_config_t *config)
+{
+    return mlfq_traced(context, processes, total_num_of_process, config, NULL);
+}
+
+/********************* CFS *********************/
+
+#define CFS_NICE_0_WEIGHT 1024 // Weight of a process of priority 0
+#define CFS_VRUNTIME_UNIT 1024 // Virtual runtime of a cycle run at CFS_NICE_0_WEIGHT
+
+/* The weight of each priority, read as a nice value 0 .. 19, as in Linux: each step is about 10% less CPU */
+static const uint32_t CFS_WEIGHTS[20] = {1024, 820, 655, 526, 423, 335, 272, 215, 172, 137,
+                                         110,  87,  70,  56,  45,  36,  29,  23,  18,  15};
 
-        // Ready -> Running for Shortest Job
-        if (sj != NULL)
+/// @brief The weight of a process of the given priority, priorities above 19 weigh as 19
+static inline uint32_t cfs_weight(uint32_t priority)
+{
+    return CFS_WEIGHTS[priority < 19 ? priority : 19];
+}
+
+/* The tunables of CFS, in cycles */
+typedef struct
+{
+    uint32_t target_latency;  // The period in which every runnable process should run once, at least 1
+    uint32_t min_granularity; // The shortest slice, and how far ahead in virtual runtime a process must be
+                              // to be preempted by one that became READY, at least 1
+} cfs_config_t;
+
+/* The state of the CFS policy */
+typedef struct
+{
+    rb_tree_t ready; // READY processes ordered by virtual runtime
+    const cfs_config_t *config;
+
+    uint64_t *vruntime;    // The CPU time of every process, weighted by the inverse of its weight
+    uint64_t min_vruntime; // Never decreases, where arriving and waking processes are placed
+    uint64_t total_weight; // Of the READY and RUNNING processes
+    uint32_t num_runnable;
+} cfs_state_t;
+
+/// @brief Queues a process by virtual runtime. A process with no CPU burst left was not runnable before: an
+/// arriving process starts at min_vruntime, and a waking one keeps its virtual runtime but at most half a
+/// target latency behind min_vruntime, so sleeping earns a little credit but not a monopoly of the CPU.
+static inline void cfs_enqueue(void *state, process_table_t *t, uint32_t i)
+{
+    cfs_state_t *s = state;
+    if (t->cpu_burst[i] == 0)
+    {
+        uint64_t credit = (uint64_t)s->config->target_latency * CFS_VRUNTIME_UNIT / 2;
+        uint64_t floor = s->min_vruntime > credit ? s->min_vruntime - credit : 0;
+        if (t->cpu_time[i] == 0)
+        {
+            s->vruntime[i] = s->min_vruntime;
+        }
+        else if (s->vruntime[i] < floor)
         {
-            set_bursts(sj);
-            sj->status = RUNNING;
-            sj->waiting_time--;
+            s->vruntime[i] = floor;
         }
 
-        r.current_cycle++;
+        t->quantum[i] = 0;
+        s->total_weight += cfs_weight(t->priority[i]);
+        s->num_runnable++;
     }
+    rb_tree_insert(&s->ready, i, s->vruntime[i]);
+}
+
+/// @brief Charges the cycle run to the virtual runtime, and drops a process that terminated or blocked from
+/// the runnable weight
+static inline void cfs_tick(void *state, process_table_t *t, uint32_t i)
+{
+    cfs_state_t *s = state;
+    uint32_t weight = cfs_weight(t->priority[i]);
+    s->vruntime[i] += (uint64_t)CFS_VRUNTIME_UNIT * CFS_NICE_0_WEIGHT / weight;
+    t->quantum[i]--;
+
+    uint64_t least = s->vruntime[i];
+    if (!rb_tree_empty(&s->ready) && s->ready.key[rb_tree_first(&s->ready)] < least)
+    {
+        least = s->ready.key[rb_tree_first(&s->ready)];
+    }
+    s->min_vruntime = least > s->min_vruntime ? least : s->min_vruntime;
+
+    if (t->status[i] != RUNNING)
+    {
+        s->total_weight -= weight;
+        s->num_runnable--;
+    }
+}
+
+/// @brief The slice of a process: its share by weight of a period of target_latency cycles, stretched to
+/// min_granularity cycles per runnable process when there are many
+static inline uint32_t cfs_slice(const cfs_state_t *s, const process_table_t *t, uint32_t i)
+{
+    uint64_t period = (uint64_t)s->config->min_granularity * s->num_runnable;
+    period = period > s->config->target_latency ? period : s->config->target_latency;
+
+    uint64_t slice = period * cfs_weight(t->priority[i]) / (s->total_weight ? s->total_weight : 1);
+    return slice > 1 ? (uint32_t)slice : 1;
+}
+
+/// @brief Once its slice is used up, the process makes way for the READY process with the least virtual
+/// runtime if that is less than its own, or else starts a new slice. Before that, a READY process more than
+/// min_granularity behind takes over the CPU, as a woken process does in Linux.
+static inline bool cfs_preempt(void *state, process_table_t *t, uint32_t i)
+{
+    cfs_state_t *s = state;
+    if (rb_tree_empty(&s->ready))
+    {
+        return false;
+    }
+
+    uint64_t least = s->ready.key[rb_tree_first(&s->ready)];
+    if (t->quantum[i] > 0)
+    {
+        return least + (uint64_t)s->config->min_granularity * CFS_VRUNTIME_UNIT < s->vruntime[i];
+    }
+    if (least < s->vruntime[i])
+    {
+        return true;
+    }
+    t->quantum[i] = cfs_slice(s, t, i);
+    return false;
+}
+
+/// @brief The READY process with the least virtual runtime, once the CPU is free. A preempted process resumes
+/// the rest of its slice.
+static inline uint32_t cfs_pick(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running)
+{
+    (void)scan_from;
+    cfs_state_t *s = state;
+    if (num_running || rb_tree_empty(&s->ready))
+    {
+        return NO_PROCESS;
+    }
+
+    uint32_t i = rb_tree_pop_first(&s->ready);
+    if (t->quantum[i] == 0)
+    {
+        t->quantum[i] = cfs_slice(s, t, i);
+    }
+    return i;
+}
+
+static const scheduler_policy_t CFS_POLICY = {
+    .enqueue = cfs_enqueue,
+    .tick = cfs_tick,
+    .preempt = cfs_preempt,
+    .pick = cfs_pick,
+};
+
+/// @brief Completely Fair Scheduler (CFS), modelled on the Linux scheduler of that name
+///
+/// Every process accumulates virtual runtime, its CPU time divided by its weight (see cfs_weight(), from its
+/// priority), and the READY process with the least virtual runtime runs next, for a slice proportional to its
+/// weight. Over time every process gets a share of the CPU proportional to its weight while it is runnable.
+/// READY processes are kept in a red-black tree, so picking the next one is O(1) and queueing O(log N).
+/// @param config the target latency and minimum granularity
+/// @param trace the log to record every cycle in, or NULL
+static inline scheduler_result_t cfs_traced(const sched_context_t *context, process_t *processes,
+                                            uint32_t total_num_of_process, const cfs_config_t *config,
+                                            trace_log_t *trace)
+{
+    assert(config->target_latency >= 1 && config->min_granularity >= 1);
+
+    cfs_state_t state = {.config = config};
+    rb_tree_init(&state.ready, total_num_of_process, &context->allocator);
+    state.vruntime = sched_calloc(&context->allocator, total_num_of_process, sizeof(uint64_t));
+
+    scheduler_result_t r = engine_run(context, processes, total_num_of_process, &CFS_POLICY, &state, trace);
+
+    rb_tree_free(&state.ready);
+    sched_free(&context->allocator, state.vruntime);
     return r;
 }
 
-/// @brief Round Robin (RR) Scheduler
-/// @param quantum the time quantum for the scheduler
-scheduler_result_t rr(process_t *processes, uint32_t total_num_of_process, uint8_t quantum)
+/// @brief cfs_traced() without a trace
+static inline scheduler_result_t cfs(const sched_context_t *context, process_t *processes,
+                                     uint32_t total_num_of_process, const cfs_config_t *config)
 {
-    qsort(processes, total_num_of_process, sizeof(process_t), cmpr_process_a);
+    return cfs_traced(context, processes, total_num_of_process, config, NULL);
+}
+
+/********************* EDF *********************/
+
+/// @brief The cycle a process should finish by, after every cycle for a process without a deadline
+static inline uint64_t edf_absolute_deadline(const process_table_t *t, uint32_t i)
+{
+    return t->deadline[i] ? (uint64_t)t->A[i] + t->deadline[i] : UINT64_MAX;
+}
+
+static inline void edf_enqueue(void *state, process_table_t *t, uint32_t i)
+{
+    ready_queue_push(state, i, edf_absolute_deadline(t, i));
+}
+
+/// @brief A READY process with an earlier deadline takes over the CPU
+static inline bool edf_preempt(void *state, process_table_t *t, uint32_t i)
+{
+    return !ready_queue_empty(state) && edf_absolute_deadline(t, ready_queue_peek(state)) < edf_absolute_deadline(t, i);
+}
+
+/// @brief The READY process with the earliest deadline, once the CPU is free
+static inline uint32_t edf_pick(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running)
+{
+    (void)t, (void)scan_from;
+    return num_running || ready_queue_empty(state) ? NO_PROCESS : ready_queue_pop(state);
+}
 
-    scheduler_result_t r = {0}; // Result of the scheduler
-    process_t *rp = NULL;       // Running process
-    process_t *p = NULL;        // Process
+static const scheduler_policy_t EDF_POLICY = {.enqueue = edf_enqueue, .preempt = edf_preempt, .pick = edf_pick};
 
-    while (r.total_finished_processes < total_num_of_process)
+/// @brief Preemptive Earliest Deadline First (EDF) Scheduler
+///
+/// The READY process with the earliest absolute deadline, its arrival time plus its relative deadline D, runs
+/// and takes over the CPU from any process with a later one. Processes without a deadline run when no process
+/// with one is READY. The ready queue is a min-heap on the deadline, so the preemption check is a peek.
+/// @param trace the log to record every cycle in, or NULL
+static inline scheduler_result_t edf_traced(const sched_context_t *context, process_t *processes,
+                                            uint32_t total_num_of_process, trace_log_t *trace)
+{
+    ready_queue_t ready; // READY processes ordered by absolute deadline
+    ready_queue_init(&ready, total_num_of_process, &context->allocator);
+
+    scheduler_result_t r = engine_run(context, processes, total_num_of_process, &EDF_POLICY, &ready, trace);
+
+    ready_queue_free(&ready);
+    return r;
+}
+
+/// @brief edf_traced() without a trace
+static inline scheduler_result_t edf(const sched_context_t *context, process_t *processes,
+                                     uint32_t total_num_of_process)
+{
+    return edf_traced(context, processes, total_num_of_process, NULL);
+}
+
+/********************* PROPORTIONAL SHARE *********************/
+
+#define SHARE_DEFAULT_TICKETS 100 // Tickets of a process without any, so an input without tickets shares evenly
+
+/// @brief The tickets a process holds, from its input field T
+static inline uint32_t share_tickets(uint32_t tickets)
+{
+    return tickets ? tickets : SHARE_DEFAULT_TICKETS;
+}
+
+/* The CPU time the tickets of every process entitle it to: each cycle a process runs is shared out among the
+ * runnable processes by tickets, so the entitlements add up to the CPU time. Rather than crediting every
+ * runnable process every cycle, `progress` sums the share of a single ticket, and a process is credited its
+ * tickets times the progress made while it was runnable. */
+typedef struct
+{
+    double progress;           // The CPU time one ticket was entitled to so far
+    double *joined;            // joined[i] is the progress when process i last became runnable
+    double *entitled;          // entitled[i] is the CPU time process i was entitled to before it last became runnable
+    uint64_t runnable_tickets; // Of the READY and RUNNING processes
+    bool busy;                 // Whether a process runs the coming cycle
+
+    const sched_allocator_t *allocator; // Where joined and entitled come from
+} share_account_t;
+
+static inline void share_account_init(share_account_t *a, uint32_t total_num_of_process,
+                                      const sched_allocator_t *allocator)
+{
+    *a = (share_account_t){.allocator = allocator};
+    a->joined = sched_calloc(allocator, total_num_of_process, sizeof(double));
+    a->entitled = sched_calloc(allocator, total_num_of_process, sizeof(double));
+}
+
+static inline void share_account_free(share_account_t *a)
+{
+    sched_free(a->allocator, a->joined);
+    sched_free(a->allocator, a->entitled);
+    *a = (share_account_t){0};
+}
+
+/// @brief A process arrived or woke up
+static inline void share_account_join(share_account_t *a, const process_table_t *t, uint32_t i)
+{
+    a->joined[i] = a->progress;
+    a->runnable_tickets += share_tickets(t->tickets[i]);
+}
+
+/// @brief The running process terminated or blocked
+static inline void share_account_leave(share_account_t *a, const process_table_t *t, uint32_t i)
+{
+    uint32_t tickets = share_tickets(t->tickets[i]);
+    a->entitled[i] += tickets * (a->progress - a->joined[i]);
+    a->runnable_tickets -= tickets;
+    a->busy = false;
+}
+
+/// @brief Shares out the cycle about to run, unless the CPU is idle
+static inline void share_account_cycle(share_account_t *a)
+{
+    if (a->busy)
     {
-        const process_t *mo = rp == NULL ? processes : rp;
-        for (int i = 0; i < total_num_of_process; i++)
-        {
-            p = circular_iterator(processes, mo, i, total_num_of_process);
+        a->progress += 1.0 / a->runnable_tickets;
+    }
+}
 
-            // Terminated
-            if (p->status == TERMINATED)
-            {
-                continue;
-            }
+/// @brief Hands the entitlements to the processes, once every process has terminated
+static inline void share_account_store(const share_account_t *a, process_t *processes, uint32_t total_num_of_process)
+{
+    for (uint32_t i = 0; i < total_num_of_process; i++)
+    {
+        processes[i].entitled_time = a->entitled[i];
+    }
+}
 
-            // Blocked
-            if (p->status == BLOCKED)
-            {
-                p->blocked_time++;
-                p->io_burst--;
+/********************* LOTTERY *********************/
 
-                // Blocked -> Ready
-                p->status = p->io_burst ? BLOCKED : READY;
+/* The state of the lottery policy */
+typedef struct
+{
+    fenwick_t ready; // The tickets of the READY processes
+    share_account_t share;
+    uint8_t quantum;
+    uint64_t draws;  // Lotteries held so far, each reads the next number of the random table
+    uint32_t winner; // The READY process that won the lottery held at the last preemption, or NO_PROCESS
+} lottery_state_t;
 
-                r.total_number_of_cycles_spent_blocked++;
-            }
+/// @brief Draws one of `tickets` tickets
+static inline uint64_t lottery_draw(lottery_state_t *s, const process_table_t *t, uint64_t tickets)
+{
+    return random_ticket(t->context->random, tickets, s->draws++);
+}
 
-            // Unstarted -> Ready
-            else if (p->status == UNSTARTED && p->A == r.current_cycle)
-            {
-                p->cpu_time = 0;
-                p->blocked_time = 0;
-                p->waiting_time = 0;
-                p->is_first_run = true;
+static inline void lottery_enqueue(void *state, process_table_t *t, uint32_t i)
+{
+    lottery_state_t *s = state;
+    if (t->cpu_burst[i] == 0)
+    {
+        share_account_join(&s->share, t, i);
+    }
+    fenwick_add(&s->ready, i, share_tickets(t->tickets[i]));
+}
 
-                p->status = READY;
+static inline void lottery_age(void *state, process_table_t *t)
+{
+    (void)t;
+    share_account_cycle(&((lottery_state_t *)state)->share);
+}
 
-                r.total_created_processes++;
-            }
+static inline void lottery_tick(void *state, process_table_t *t, uint32_t i)
+{
+    lottery_state_t *s = state;
+    t->quantum[i]--;
+    if (t->status[i] != RUNNING)
+    {
+        share_account_leave(&s->share, t, i);
+    }
+}
 
-            // Ready
-            if (p->status == READY)
-            {
-                // Ready -> Running
-                if (rp == NULL)
-                {
-                    set_bursts(p);
-                    p->status = RUNNING;
-                    rp = p;
-                }
-                else
-                {
-                    p->waiting_time++;
-                }
-            }
+/// @brief Once the quantum is used up, a lottery among the READY processes and this one decides which runs
+/// next. The process starts a new quantum if it wins.
+static inline bool lottery_preempt(void *state, process_table_t *t, uint32_t i)
+{
+    lottery_state_t *s = state;
+    if (t->quantum[i] > 0)
+    {
+        return false;
+    }
 
-            // Running
-            else if (p->status == RUNNING)
-            {
-                p->cpu_time++;
-                p->cpu_burst -= quantum;
-                r.total_started_processes += p->is_first_run;
-                p->is_first_run = false;
-
-                // Running -> Terminate
-                if (p->cpu_time >= p->C)
-                {
-                    p->status = TERMINATED;
-                    p->finished_time = r.current_cycle;
-                    rp = NULL;
-
-                    r.total_finished_processes++;
-                }
-
-                // Running -> Block
-                else
-                {
-                    rp = NULL;
-                    p->status = BLOCKED;
-                }
-            }
+    if (s->ready.total)
+    {
+        uint64_t ticket = lottery_draw(s, t, s->ready.total + share_tickets(t->tickets[i]));
+        if (ticket < s->ready.total)
+        {
+            s->winner = fenwick_find(&s->ready, ticket);
+            s->share.busy = false;
+            return true;
         }
+    }
+    t->quantum[i] = s->quantum;
+    return false;
+}
 
-        r.current_cycle++;
+/// @brief The winner of a lottery among the READY processes, once the CPU is free
+static inline uint32_t lottery_pick(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running)
+{
+    (void)scan_from;
+    lottery_state_t *s = state;
+    if (num_running || !s->ready.total)
+    {
+        return NO_PROCESS;
     }
+
+    uint32_t i = s->winner != NO_PROCESS ? s->winner : fenwick_find(&s->ready, lottery_draw(s, t, s->ready.total));
+    s->winner = NO_PROCESS;
+    fenwick_add(&s->ready, i, -(int64_t)share_tickets(t->tickets[i]));
+    t->quantum[i] = s->quantum;
+    s->share.busy = true;
+    return i;
+}
+
+static const scheduler_policy_t LOTTERY_POLICY = {
+    .enqueue = lottery_enqueue,
+    .age = lottery_age,
+    .tick = lottery_tick,
+    .preempt = lottery_preempt,
+    .pick = lottery_pick,
+};
+
+/// @brief Lottery Scheduler
+///
+/// Every process holds tickets (T, see share_tickets()) and the CPU goes to the holder of a ticket drawn at
+/// random, for `quantum` cycles at most, so over time every process gets a share of the CPU proportional to its
+/// tickets while it is runnable. The tickets of the READY processes are kept in a Fenwick tree, so a draw and
+/// queueing are O(log N). The draws come from the random table, so a run is reproducible. The CPU time every
+/// process was entitled to is left in its entitled_time.
+/// @param quantum the most cycles a process runs before the next lottery, at least 1
+/// @param trace the log to record every cycle in, or NULL
+static inline scheduler_result_t lottery_traced(const sched_context_t *context, process_t *processes,
+                                                uint32_t total_num_of_process, uint8_t quantum, trace_log_t *trace)
+{
+    assert(quantum >= 1);
+
+    lottery_state_t state = {.quantum = quantum, .winner = NO_PROCESS};
+    fenwick_init(&state.ready, total_num_of_process, &context->allocator);
+    share_account_init(&state.share, total_num_of_process, &context->allocator);
+
+    scheduler_result_t r = engine_run(context, processes, total_num_of_process, &LOTTERY_POLICY, &state, trace);
+    share_account_store(&state.share, processes, total_num_of_process);
+
+    fenwick_free(&state.ready);
+    share_account_free(&state.share);
     return r;
-}
\ No newline at end of file
+}
+
+/// @brief lottery_traced() without a trace
+static inline scheduler_result_t lottery(const sched_context_t *context, process_t *processes,
+                                         uint32_t total_num_of_process, uint8_t quantum)
+{
+    return lottery_traced(context, processes, total_num_of_process, quantum, NULL);
+}
+
+/********************* STRIDE *********************/
+
+#define STRIDE_ONE (1u << 20) // The pass a process of a single ticket advances by per cycle run
+
+/* The state of the stride policy */
+typedef struct
+{
+    ready_queue_t ready; // READY processes ordered by pass
+    share_account_t share;
+    uint8_t quantum;
+    uint64_t *pass;       // The CPU time of every process, weighted by the inverse of its tickets
+    uint64_t global_pass; // Never decreases, where arriving and waking processes are placed
+} stride_state_t;
+
+/// @brief The pass a process advances by per cycle run
+static inline uint64_t stride_of(const process_table_t *t, uint32_t i)
+{
+    uint64_t stride = STRIDE_ONE / share_tickets(t->tickets[i]);
+    return stride ? stride : 1;
+}
+
+/// @brief Queues a process by pass. An arriving or waking process is moved up to the global pass, so the time
+/// it was not runnable earns it no credit.
+static inline void stride_enqueue(void *state, process_table_t *t, uint32_t i)
+{
+    stride_state_t *s = state;
+    if (t->cpu_burst[i] == 0)
+    {
+        s->pass[i] = s->pass[i] > s->global_pass ? s->pass[i] : s->global_pass;
+        share_account_join(&s->share, t, i);
+    }
+    ready_queue_push(&s->ready, i, s->pass[i]);
+}
+
+static inline void stride_age(void *state, process_table_t *t)
+{
+    (void)t;
+    share_account_cycle(&((stride_state_t *)state)->share);
+}
+
+/// @brief Advances the pass by the cycle run, and the global pass to the least pass of a runnable process
+static inline void stride_tick(void *state, process_table_t *t, uint32_t i)
+{
+    stride_state_t *s = state;
+    s->pass[i] += stride_of(t, i);
+    t->quantum[i]--;
+
+    uint64_t least = t->status[i] == RUNNING ? s->pass[i] : UINT64_MAX;
+    if (!ready_queue_empty(&s->ready) && s->ready.keys[ready_queue_peek(&s->ready)] < least)
+    {
+        least = s->ready.keys[ready_queue_peek(&s->ready)];
+    }
+    s->global_pass = least != UINT64_MAX && least > s->global_pass ? least : s->global_pass;
+
+    if (t->status[i] != RUNNING)
+    {
+        share_account_leave(&s->share, t, i);
+    }
+}
+
+/// @brief Once the quantum is used up, the process makes way for the READY process with the least pass if
+/// that is less than its own, or else starts a new quantum
+static inline bool stride_preempt(void *state, process_table_t *t, uint32_t i)
+{
+    stride_state_t *s = state;
+    if (t->quantum[i] > 0)
+    {
+        return false;
+    }
+    if (!ready_queue_empty(&s->ready) && s->ready.keys[ready_queue_peek(&s->ready)] < s->pass[i])
+    {
+        s->share.busy = false;
+        return true;
+    }
+    t->quantum[i] = s->quantum;
+    return false;
+}
+
+/// @brief The READY process with the least pass, once the CPU is free
+static inline uint32_t stride_pick(void *state, process_table_t *t, uint32_t scan_from, uint32_t num_running)
+{
+    (void)scan_from;
+    stride_state_t *s = state;
+    if (num_running || ready_queue_empty(&s->ready))
+    {
+        return NO_PROCESS;
+    }
+
+    uint32_t i = ready_queue_pop(&s->ready);
+    t->quantum[i] = s->quantum;
+    s->share.busy = true;
+    return i;
+}
+
+static const scheduler_policy_t STRIDE_POLICY = {
+    .enqueue = stride_enqueue,
+    .age = stride_age,
+    .tick = stride_tick,
+    .preempt = stride_preempt,
+    .pick = stride_pick,
+};
+
+/// @brief Stride Scheduler, the deterministic counterpart of the lottery scheduler
+///
+/// Every process advances its pass by its stride, STRIDE_ONE over its tickets, for every cycle it runs, and the
+/// READY process with the least pass runs next, for `quantum` cycles at most. A process so gets a share of the
+/// CPU proportional to its tickets while it is runnable, off by at most a quantum at any time rather than
+/// only on average. READY processes are kept in a min-heap on pass. The CPU time every process was entitled to
+/// is left in its entitled_time.
+/// @param quantum the most cycles a process runs before the passes are compared, at least 1
+/// @param trace the log to record every cycle in, or NULL
+static inline scheduler_result_t stride_traced(const sched_context_t *context, process_t *processes,
+                                               uint32_t total_num_of_process, uint8_t quantum, trace_log_t *trace)
+{
+    assert(quantum >= 1);
+
+    stride_state_t state = {.quantum = quantum};
+    ready_queue_init(&state.ready, total_num_of_process, &context->allocator);
+    share_account_init(&state.share, total_num_of_process, &context->allocator);
+    state.pass = sched_calloc(&context->allocator, total_num_of_process, sizeof(uint64_t));
+
+    scheduler_result_t r = engine_run(context, processes, total_num_of_process, &STRIDE_POLICY, &state, trace);
+    share_account_store(&state.share, processes, total_num_of_process);
+
+    ready_queue_free(&state.ready);
+    share_account_free(&state.share);
+    sched_free(&context->allocator, state.pass);
+    return r;
+}
+
+/// @brief stride_traced() without a trace
+static inline scheduler_result_t stride(const sched_context_t *context, process_t *processes,
+                                        uint32_t total_num_of_process, uint8_t quantum)
+{
+    return stride_traced(context, processes, total_num_of_process, quantum, NULL);
+}
+
+#endif // SCHEDULER_H
@@ -0,0 +1,211 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "process.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SWEEP_X86 1
+#endif
+
+/*
+ * The per-cycle sweep shared by every tick scheduler, over the packed arrays of a process table:
+ *   BLOCKED: blocked_time++, io_burst--, and Blocked -> Ready once io_burst reaches 0
+ *   READY (including the processes that just woke up): waiting_time++
+ * Every kernel sets bit i of `woken` for the processes that became READY and returns how many processes
+ * were BLOCKED. The SSE2 and AVX2 kernels do the same work with compare masks instead of branches, and
+ * finish the last few processes with the scalar kernel.
+ */
+
+typedef uint32_t (*sweep_kernel_fn)(uint8_t *status, uint32_t *io_burst, uint32_t *blocked_time,
+                                    uint32_t *waiting_time, uint64_t *woken, uint32_t n);
+
+typedef enum
+{
+    SWEEP_AUTO = 0,   // Fastest kernel the CPU supports
+    SWEEP_SCALAR = 1, // Plain C, runs everywhere
+    SWEEP_SSE2 = 2,   // 16 processes per step
+    SWEEP_AVX2 = 3    // 8 processes per step with 256 bit counters
+} sweep_kernel;
+
+/// @brief Sweeps processes from..n-1 one at a time. `woken` must be cleared by the caller.
+static inline uint32_t sweep_scalar_from(uint8_t *status, uint32_t *io_burst, uint32_t *blocked_time,
+                                         uint32_t *waiting_time, uint64_t *woken, uint32_t from, uint32_t n)
+{
+    uint32_t blocked = 0;
+    for (uint32_t i = from; i < n; i++)
+    {
+        uint32_t is_blocked = status[i] == BLOCKED;
+        uint32_t io = io_burst[i] - is_blocked;
+        uint64_t wakes = is_blocked & (io == 0);
+        uint8_t s = wakes ? READY : status[i];
+
+        io_burst[i] = io;
+        blocked_time[i] += is_blocked;
+        waiting_time[i] += s == READY;
+        status[i] = s;
+        woken[i / 64] |= wakes << (i % 64);
+
+        blocked += is_blocked;
+    }
+    return blocked;
+}
+
+static inline void sweep_clear_woken(uint64_t *woken, uint32_t n)
+{
+    memset(woken, 0, sizeof(uint64_t) * ((n + 63) / 64));
+}
+
+static inline uint32_t sweep_scalar(uint8_t *status, uint32_t *io_burst, uint32_t *blocked_time,
+                                    uint32_t *waiting_time, uint64_t *woken, uint32_t n)
+{
+    sweep_clear_woken(woken, n);
+    return sweep_scalar_from(status, io_burst, blocked_time, waiting_time, woken, 0, n);
+}
+
+#ifdef SWEEP_X86
+static inline __attribute__((target("sse2"))) uint32_t sweep_sse2(uint8_t *status, uint32_t *io_burst,
+                            uint32_t *blocked_time, uint32_t *waiting_time, uint64_t *woken, uint32_t n)
+{
+    sweep_clear_woken(woken, n);
+
+    const __m128i blocked_state = _mm_set1_epi8(BLOCKED);
+    const __m128i ready_state = _mm_set1_epi8(READY);
+    const __m128i zero = _mm_setzero_si128();
+
+    uint32_t blocked = 0;
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i *)(status + i));
+        __m128i is_blocked = _mm_cmpeq_epi8(s, blocked_state);
+
+        // Widen the byte mask to one 32 bit mask per counter
+        __m128i b16[2] = {_mm_unpacklo_epi8(is_blocked, is_blocked), _mm_unpackhi_epi8(is_blocked, is_blocked)};
+        __m128i b32[4] = {_mm_unpacklo_epi16(b16[0], b16[0]), _mm_unpackhi_epi16(b16[0], b16[0]),
+                          _mm_unpacklo_epi16(b16[1], b16[1]), _mm_unpackhi_epi16(b16[1], b16[1])};
+
+        __m128i wakes32[4];
+        for (int k = 0; k < 4; k++)
+        {
+            __m128i *io_ptr = (__m128i *)(io_burst + i + 4 * k);
+            __m128i *bt_ptr = (__m128i *)(blocked_time + i + 4 * k);
+
+            // A set mask is -1, so adding it decrements and subtracting it increments
+            __m128i io = _mm_add_epi32(_mm_loadu_si128(io_ptr), b32[k]);
+            _mm_storeu_si128(io_ptr, io);
+            _mm_storeu_si128(bt_ptr, _mm_sub_epi32(_mm_loadu_si128(bt_ptr), b32[k]));
+
+            wakes32[k] = _mm_and_si128(b32[k], _mm_cmpeq_epi32(io, zero));
+        }
+
+        // Narrow the wake masks back to bytes, -1 and 0 survive the saturation
+        __m128i wakes = _mm_packs_epi16(_mm_packs_epi32(wakes32[0], wakes32[1]), _mm_packs_epi32(wakes32[2], wakes32[3]));
+
+        // Blocked -> Ready
+        s = _mm_or_si128(_mm_and_si128(wakes, ready_state), _mm_andnot_si128(wakes, s));
+        _mm_storeu_si128((__m128i *)(status + i), s);
+
+        // Ready
+        __m128i is_ready = _mm_cmpeq_epi8(s, ready_state);
+        __m128i r16[2] = {_mm_unpacklo_epi8(is_ready, is_ready), _mm_unpackhi_epi8(is_ready, is_ready)};
+        __m128i r32[4] = {_mm_unpacklo_epi16(r16[0], r16[0]), _mm_unpackhi_epi16(r16[0], r16[0]),
+                          _mm_unpacklo_epi16(r16[1], r16[1]), _mm_unpackhi_epi16(r16[1], r16[1])};
+        for (int k = 0; k < 4; k++)
+        {
+            __m128i *wt_ptr = (__m128i *)(waiting_time + i + 4 * k);
+            _mm_storeu_si128(wt_ptr, _mm_sub_epi32(_mm_loadu_si128(wt_ptr), r32[k]));
+        }
+
+        woken[i / 64] |= (uint64_t)(uint32_t)_mm_movemask_epi8(wakes) << (i % 64);
+        blocked += __builtin_popcount(_mm_movemask_epi8(is_blocked));
+    }
+
+    return blocked + sweep_scalar_from(status, io_burst, blocked_time, waiting_time, woken, i, n);
+}
+
+static inline __attribute__((target("avx2"))) uint32_t sweep_avx2(uint8_t *status, uint32_t *io_burst,
+                            uint32_t *blocked_time, uint32_t *waiting_time, uint64_t *woken, uint32_t n)
+{
+    sweep_clear_woken(woken, n);
+
+    const __m256i blocked_state = _mm256_set1_epi32(BLOCKED);
+    const __m256i ready_state = _mm256_set1_epi32(READY);
+    const __m256i zero = _mm256_setzero_si256();
+
+    uint32_t blocked = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        // One status per 32 bit lane, lined up with the counters
+        __m256i s = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(status + i)));
+        __m256i is_blocked = _mm256_cmpeq_epi32(s, blocked_state);
+
+        // A set mask is -1, so adding it decrements and subtracting it increments
+        __m256i io = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(io_burst + i)), is_blocked);
+        _mm256_storeu_si256((__m256i *)(io_burst + i), io);
+
+        __m256i bt = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(blocked_time + i)), is_blocked);
+        _mm256_storeu_si256((__m256i *)(blocked_time + i), bt);
+
+        // Blocked -> Ready
+        __m256i wakes = _mm256_and_si256(is_blocked, _mm256_cmpeq_epi32(io, zero));
+        s = _mm256_blendv_epi8(s, ready_state, wakes);
+
+        // Ready
+        __m256i is_ready = _mm256_cmpeq_epi32(s, ready_state);
+        __m256i wt = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(waiting_time + i)), is_ready);
+        _mm256_storeu_si256((__m256i *)(waiting_time + i), wt);
+
+        // Narrow the statuses back to bytes
+        __m128i s16 = _mm_packus_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+        _mm_storel_epi64((__m128i *)(status + i), _mm_packus_epi16(s16, s16));
+
+        woken[i / 64] |= (uint64_t)(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(wakes)) << (i % 64);
+        blocked += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(is_blocked)));
+    }
+
+    return blocked + sweep_scalar_from(status, io_burst, blocked_time, waiting_time, woken, i, n);
+}
+#endif
+
+/// @brief Whether a kernel can run on this CPU
+static inline bool sweep_kernel_supported(sweep_kernel kind)
+{
+    switch (kind)
+    {
+    case SWEEP_AUTO:
+    case SWEEP_SCALAR:
+        return true;
+#ifdef SWEEP_X86
+    case SWEEP_SSE2:
+        return __builtin_cpu_supports("sse2");
+    case SWEEP_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+/// @brief Resolves a kernel, SWEEP_AUTO picks the fastest one the CPU supports
+/// @return the kernel, or the scalar kernel if the requested one is not supported
+static inline sweep_kernel_fn sweep_kernel_select(sweep_kernel kind)
+{
+#ifdef SWEEP_X86
+    if ((kind == SWEEP_AUTO || kind == SWEEP_AVX2) && sweep_kernel_supported(SWEEP_AVX2))
+    {
+        return sweep_avx2;
+    }
+    if ((kind == SWEEP_AUTO || kind == SWEEP_SSE2) && sweep_kernel_supported(SWEEP_SSE2))
+    {
+        return sweep_sse2;
+    }
+#endif
+    return sweep_scalar;
+}
+
+#endif // SWEEP_H
@@ -1,8 +1,27 @@
 #define UNIT_TEST_ENV
 
 #include <assert.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
 
 #include "scheduler.h"
+#include "event.h"
+#include "multicore.h"
+#include "timer_wheel.h"
+#include "loader.h"
+#include "workload_gen.h"
+#include "writer.h"
+
+// randomOS() and random_ticket() draw fixed values in the unit tests, so the table stays empty
+const random_table_t TEST_RANDOM_TABLE = {0};
+const sched_context_t TEST_CONTEXT = {.random = &TEST_RANDOM_TABLE};
+
+// See test_link.c
+scheduler_result_t test_link_rr(const sched_context_t *context, process_t *processes, uint32_t total_num_of_process,
+                                uint8_t quantum);
 
 void assert_result(scheduler_result_t got, scheduler_result_t expected)
 {
@@ -38,7 +57,7 @@ void test_fcfs_input1()
     };
 
     // Act
-    scheduler_result_t result = fcfs(processes, 1);
+    scheduler_result_t result = fcfs(&TEST_CONTEXT, processes, 1);
 
     // Assert
     scheduler_result_t expected = {
@@ -76,7 +95,7 @@ void test_fcfs_input2()
     };
 
     // Act
-    scheduler_result_t result = fcfs(processes, 2);
+    scheduler_result_t result = fcfs(&TEST_CONTEXT, processes, 2);
 
     // Assert
     scheduler_result_t expected = {
@@ -119,7 +138,7 @@ void test_fcfs_input3()
     };
 
     // Act
-    scheduler_result_t result = fcfs(processes, 3);
+    scheduler_result_t result = fcfs(&TEST_CONTEXT, processes, 3);
 
     // Assert
     scheduler_result_t expected = {
@@ -158,7 +177,7 @@ void test_sjf_input1()
     };
 
     // Act
-    scheduler_result_t result = sjf(processes, 1);
+    scheduler_result_t result = sjf(&TEST_CONTEXT, processes, 1);
 
     // Assert
     scheduler_result_t expected = {
@@ -197,7 +216,7 @@ void test_sjf_input2()
     };
 
     // Act
-    scheduler_result_t result = sjf(processes, 2);
+    scheduler_result_t result = sjf(&TEST_CONTEXT, processes, 2);
 
     // Assert
     scheduler_result_t expected = {
@@ -241,7 +260,7 @@ void test_sjf_input3()
     };
 
     // Act
-    scheduler_result_t result = sjf(processes, 3);
+    scheduler_result_t result = sjf(&TEST_CONTEXT, processes, 3);
 
     // Assert
     scheduler_result_t expected = {
@@ -278,7 +297,7 @@ void test_rr_input1()
     };
 
     // Act
-    scheduler_result_t result = rr(processes, 1, 2);
+    scheduler_result_t result = rr(&TEST_CONTEXT, processes, 1, 2, false);
 
     // Assert
     scheduler_result_t expected = {
@@ -317,7 +336,7 @@ void test_rr_input2()
     };
 
     // Act
-    scheduler_result_t result = rr(processes, 2, 2);
+    scheduler_result_t result = rr(&TEST_CONTEXT, processes, 2, 2, false);
 
     // Assert
     scheduler_result_t expected = {
@@ -361,7 +380,7 @@ void test_rr_input3()
     };
 
     // Act
-    scheduler_result_t result = rr(processes, 3, 2);
+    scheduler_result_t result = rr(&TEST_CONTEXT, processes, 3, 2, false);
 
     // Assert
     scheduler_result_t expected = {
@@ -375,19 +394,1800 @@ void test_rr_input3()
     assert_result(result, expected);
 }
 
-int main()
+/// Fills a process array with pseudo-random (A B C M) tuples
+void random_workload(process_t *processes, uint32_t n, uint32_t seed)
 {
-    test_fcfs_input1();
-    test_fcfs_input2();
-    test_fcfs_input3();
+    srand(seed);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        processes[i] = (process_t){
+            .A = rand() % 40,
+            .B = 1 + rand() % 12,
+            .C = rand() % 60,
+            .M = 1 + rand() % 4,
+            .id = i,
+        };
+    }
+}
 
-    test_sjf_input1();
-    test_sjf_input2();
-    test_sjf_input3();
+/// Asserts two runs produced the same result and per-process stats
+void assert_same_run(process_t *got, scheduler_result_t got_result, process_t *expected, scheduler_result_t expected_result, uint32_t n)
+{
+    assert_result(got_result, expected_result);
+    assert(got_result.total_number_of_cycles_spent_blocked == expected_result.total_number_of_cycles_spent_blocked);
+    assert(got_result.total_context_switches == expected_result.total_context_switches);
+    assert(got_result.total_preemptions == expected_result.total_preemptions);
+    assert(memcmp(&got_result.turnaround_times, &expected_result.turnaround_times, sizeof(histogram_t)) == 0);
+    assert(memcmp(&got_result.waiting_times, &expected_result.waiting_times, sizeof(histogram_t)) == 0);
+    assert(memcmp(&got_result.response_times, &expected_result.response_times, sizeof(histogram_t)) == 0);
+    assert(memcmp(&got_result.io_times, &expected_result.io_times, sizeof(histogram_t)) == 0);
 
-    test_rr_input1();
-    test_rr_input2();
-    test_rr_input3();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        assert(got[i].id == expected[i].id);
+        assert(got[i].finished_time == expected[i].finished_time);
+        assert(got[i].cpu_time == expected[i].cpu_time);
+        assert(got[i].blocked_time == expected[i].blocked_time);
+        assert(got[i].waiting_time == expected[i].waiting_time);
+    }
+}
+
+/// Asserts every run of `got` matches the run of `expected` in the same slice, runs of n processes each
+void assert_same_runs(process_t *got, const scheduler_result_t *got_results, process_t *expected,
+                      const scheduler_result_t *expected_results, uint32_t n, uint32_t num_runs)
+{
+    for (uint32_t s = 0; s < num_runs; s++)
+    {
+        assert_same_run(&got[s * n], got_results[s], &expected[s * n], expected_results[s], n);
+    }
+}
+
+/* A scheduler run on the test context, for assert_same_on_random_workloads() */
+typedef scheduler_result_t (*test_run_t)(process_t *processes, uint32_t n);
+
+/// Runs two schedulers on the same randomized workloads of 1 .. 64 processes and asserts they agree on each
+void assert_same_on_random_workloads(test_run_t got, test_run_t expected, uint32_t num_seeds)
+{
+    process_t got_processes[64];
+    process_t expected_processes[64];
+
+    for (uint32_t seed = 1; seed <= num_seeds; seed++)
+    {
+        uint32_t n = 1 + seed % 64;
+        random_workload(expected_processes, n, seed);
+        memcpy(got_processes, expected_processes, sizeof(process_t) * n);
+
+        scheduler_result_t got_result = got(got_processes, n);
+        assert_same_run(got_processes, got_result, expected_processes, expected(expected_processes, n), n);
+    }
+}
+
+scheduler_result_t run_fcfs(process_t *processes, uint32_t n)
+{
+    return fcfs(&TEST_CONTEXT, processes, n);
+}
+
+scheduler_result_t run_sjf(process_t *processes, uint32_t n)
+{
+    return sjf(&TEST_CONTEXT, processes, n);
+}
+
+scheduler_result_t run_rr(process_t *processes, uint32_t n)
+{
+    return rr(&TEST_CONTEXT, processes, n, 2, false);
+}
+
+scheduler_result_t run_rr_preemptive(process_t *processes, uint32_t n)
+{
+    return rr(&TEST_CONTEXT, processes, n, 2, true);
+}
+
+/**
+IN: 2 ( 0 10 4 1) ( 0 10 4 1)
+Without quantum preemption both processes draw a CPU burst of 4 but block after every cycle they run, for
+the I/O of the whole burst, so each runs once every 5 cycles and the quantum makes no difference.
+**/
+void test_rr_blocks_every_cycle()
+{
+    // Arrange
+    process_t processes[] = {
+        {.A = 0, .B = 10, .C = 4, .M = 1, .id = 0},
+        {.A = 0, .B = 10, .C = 4, .M = 1, .id = 1},
+    };
+
+    // Act
+    scheduler_result_t result = rr(&TEST_CONTEXT, processes, 2, 2, false);
+
+    // Assert
+    assert(result.current_cycle == 18);
+    assert(result.total_number_of_cycles_spent_blocked == 24);
+    assert(processes[0].finished_time == 16 && processes[0].waiting_time == 0 && processes[0].blocked_time == 12);
+    assert(processes[1].finished_time == 17 && processes[1].waiting_time == 1 && processes[1].blocked_time == 12);
+}
+
+/**
+IN: 2 ( 0 10 4 1) ( 0 10 4 1)
+With quantum preemption both processes draw a CPU burst of 4 and take turns every 2 cycles (quantum 2),
+resuming their burst instead of blocking, so they finish without any I/O.
+**/
+void test_rr_quantum()
+{
+    // Arrange
+    process_t processes[] = {
+        {.A = 0, .B = 10, .C = 4, .M = 1, .id = 0},
+        {.A = 0, .B = 10, .C = 4, .M = 1, .id = 1},
+    };
+
+    // Act
+    scheduler_result_t result = rr(&TEST_CONTEXT, processes, 2, 2, true);
+
+    // Assert
+    assert(result.current_cycle == 9);
+    assert(result.total_number_of_cycles_spent_blocked == 0);
+    assert(processes[0].finished_time == 6 && processes[0].waiting_time == 1);
+    assert(processes[1].finished_time == 8 && processes[1].waiting_time == 3);
+}
+
+scheduler_result_t run_fcfs_event(process_t *processes, uint32_t n)
+{
+    return fcfs_event(&TEST_CONTEXT, processes, n);
+}
+
+scheduler_result_t run_sjf_event(process_t *processes, uint32_t n)
+{
+    return sjf_event(&TEST_CONTEXT, processes, n);
+}
+
+scheduler_result_t run_rr_event(process_t *processes, uint32_t n)
+{
+    return rr_event(&TEST_CONTEXT, processes, n, 2, false);
+}
+
+scheduler_result_t run_rr_event_preemptive(process_t *processes, uint32_t n)
+{
+    return rr_event(&TEST_CONTEXT, processes, n, 2, true);
+}
+
+/**
+ The event-driven engine must agree with the tick engine on randomized workloads
+**/
+void test_event_matches_tick()
+{
+    assert_same_on_random_workloads(run_fcfs_event, run_fcfs, 100);
+    assert_same_on_random_workloads(run_sjf_event, run_sjf, 100);
+    assert_same_on_random_workloads(run_rr_event, run_rr, 100);
+    assert_same_on_random_workloads(run_rr_event_preemptive, run_rr_preemptive, 100);
+}
+
+/**
+IN: 2 ( 0 1 5 1 5) ( 0 1 5 1 1)
+The second process has the better priority so it runs first and the two alternate from there.
+**/
+void test_priority_input2()
+{
+    // Arrange
+    process_t processes[] = {
+        {.A = 0, .B = 1, .C = 5, .M = 1, .id = 0, .priority = 5},
+        {.A = 0, .B = 1, .C = 5, .M = 1, .id = 1, .priority = 1},
+    };
+
+    // Act
+    scheduler_result_t result = priority(&TEST_CONTEXT, processes, 2, false, 0);
+
+    // Assert
+    scheduler_result_t expected = {
+        .current_cycle = 11,
+        .total_created_processes = 2,
+        .total_started_processes = 2,
+        .total_finished_processes = 2,
+    };
+
+    assert_result(result, expected);
+    assert(processes[0].finished_time == 10);
+    assert(processes[1].finished_time == 9);
+    assert(processes[0].waiting_time == 1);
+    assert(processes[1].waiting_time == 0);
+}
+
+/**
+IN: 2 ( 0 10 10 1 5) ( 2 10 2 1 1)
+Bursts are 4 cycles. Preemptive: the second process preempts the first on arrival and finishes at 4,
+the first resumes the rest of its burst and finishes at 20. Non-preemptive: the second waits for the
+first burst to end and finishes at 6, the first at 18.
+**/
+void test_priority_preemption()
+{
+    // Arrange
+    process_t preemptive[] = {
+        {.A = 0, .B = 10, .C = 10, .M = 1, .id = 0, .priority = 5},
+        {.A = 2, .B = 10, .C = 2, .M = 1, .id = 1, .priority = 1},
+    };
+    process_t non_preemptive[2];
+    memcpy(non_preemptive, preemptive, sizeof(preemptive));
+
+    // Act
+    scheduler_result_t result = priority(&TEST_CONTEXT, preemptive, 2, true, 0);
+    priority(&TEST_CONTEXT, non_preemptive, 2, false, 0);
+
+    // Assert
+    assert(result.current_cycle == 21);
+    assert(preemptive[0].finished_time == 20);
+    assert(preemptive[1].finished_time == 4);
+    assert(preemptive[0].cpu_time == 10);
+    assert(preemptive[0].waiting_time == 1);
+
+    assert(non_preemptive[0].finished_time == 18);
+    assert(non_preemptive[1].finished_time == 6);
+    assert(non_preemptive[1].waiting_time == 2);
+}
+
+/**
+IN: 2 ( 0 100 10 1) ( 2 100 2 1)
+Bursts cover the whole CPU time. The second process arrives with 2 cycles left against 8, preempts the
+first and finishes at 4, then the first resumes the rest of its burst and finishes at 12.
+**/
+void test_srtf_preempts_on_arrival()
+{
+    // Arrange
+    process_t processes[] = {
+        {.A = 0, .B = 100, .C = 10, .M = 1, .id = 0},
+        {.A = 2, .B = 100, .C = 2, .M = 1, .id = 1},
+    };
+
+    // Act
+    scheduler_result_t result = srtf(&TEST_CONTEXT, processes, 2);
+
+    // Assert
+    assert(result.current_cycle == 13);
+    assert(result.total_number_of_cycles_spent_blocked == 0);
+    assert(processes[0].finished_time == 12 && processes[0].waiting_time == 1);
+    assert(processes[1].finished_time == 4 && processes[1].waiting_time == 0);
+    assert(result.total_context_switches == 3);
+    assert(result.total_preemptions == 1);
+}
+
+/**
+IN: 1 ( 0 100 20 1) then 2 ( 0 100 20 1) ( 5 100 2 1), levels with quanta 2, 4 and 8
+Alone, the process uses up the quanta of levels 0 and 1, then stays on level 2. The second process
+arrives on level 0 while the first runs on level 1 and preempts it, and the first later resumes the
+rest of its quantum.
+**/
+void test_mlfq_demotes_and_preempts()
+{
+    // Arrange
+    mlfq_config_t config = mlfq_config(3, 2, 0);
+    process_t alone[] = {{.A = 0, .B = 100, .C = 20, .M = 1, .id = 0}};
+    process_t processes[] = {
+        {.A = 0, .B = 100, .C = 20, .M = 1, .id = 0},
+        {.A = 5, .B = 100, .C = 2, .M = 1, .id = 1},
+    };
+
+    // Act
+    scheduler_result_t alone_result = mlfq(&TEST_CONTEXT, alone, 1, &config);
+    scheduler_result_t result = mlfq(&TEST_CONTEXT, processes, 2, &config);
+
+    // Assert
+    assert(config.quantum[0] == 2 && config.quantum[1] == 4 && config.quantum[2] == 8);
+
+    assert(alone_result.current_cycle == 21 && alone[0].finished_time == 20);
+    assert(alone_result.num_levels == 3);
+    assert(alone_result.level_cycles[0] == 2 && alone_result.level_cycles[1] == 4 && alone_result.level_cycles[2] == 14);
+    assert(alone_result.total_preemptions == 0);
+
+    assert(result.current_cycle == 23);
+    assert(processes[0].finished_time == 22 && processes[0].waiting_time == 1);
+    assert(processes[1].finished_time == 7 && processes[1].waiting_time == 0);
+    assert(result.level_cycles[0] == 4 && result.level_cycles[1] == 4 && result.level_cycles[2] == 14);
+    assert(result.total_context_switches == 3 && result.total_preemptions == 1);
+}
+
+/**
+IN: 1 ( 0 10 8 1), levels with quanta 2 and 4, then 1 ( 0 100 20 1) boosted every 5 cycles
+Bursts of 4: the process sinks to level 1 during its first burst and is back on level 0 after its I/O.
+Boosts bring the CPU bound process back to level 0 every 5 cycles, so it never reaches level 2.
+**/
+void test_mlfq_promotes_and_boosts()
+{
+    // Arrange
+    mlfq_config_t two_levels = mlfq_config(2, 2, 0);
+    mlfq_config_t boosted = mlfq_config(3, 2, 5);
+    process_t io_bound[] = {{.A = 0, .B = 10, .C = 8, .M = 1, .id = 0}};
+    process_t cpu_bound[] = {{.A = 0, .B = 100, .C = 20, .M = 1, .id = 0}};
+
+    // Act
+    scheduler_result_t io_result = mlfq(&TEST_CONTEXT, io_bound, 1, &two_levels);
+    scheduler_result_t cpu_result = mlfq(&TEST_CONTEXT, cpu_bound, 1, &boosted);
+
+    // Assert
+    assert(io_result.current_cycle == 13 && io_bound[0].finished_time == 12);
+    assert(io_bound[0].blocked_time == 4);
+    assert(io_result.level_cycles[0] == 4 && io_result.level_cycles[1] == 4);
+
+    assert(cpu_result.current_cycle == 21);
+    assert(cpu_result.level_cycles[0] == 10 && cpu_result.level_cycles[1] == 10 && cpu_result.level_cycles[2] == 0);
+}
+
+/**
+IN: 2 ( 0 1000 384 1 0 0 100) ( 0 1000 384 1 0 0 300)
+Both processes run their whole CPU time in one burst of 384 cycles, with tickets 1 : 3. Stride gives the second
+process 3 cycles of every 4 until it finishes at 512, when the first has run 128, and each was entitled to
+exactly the 384 cycles it ran. The lottery draws deviate from that by a few cycles only.
+**/
+void test_lottery_and_stride_share()
+{
+    // Arrange
+    process_t lottery_processes[] = {
+        {.A = 0, .B = 1000, .C = 384, .M = 1, .id = 0, .tickets = 100},
+        {.A = 0, .B = 1000, .C = 384, .M = 1, .id = 1, .tickets = 300},
+    };
+    process_t stride_processes[2];
+    memcpy(stride_processes, lottery_processes, sizeof(lottery_processes));
+
+    // Act
+    scheduler_result_t lottery_result = lottery(&TEST_CONTEXT, lottery_processes, 2, 1);
+    scheduler_result_t stride_result = stride(&TEST_CONTEXT, stride_processes, 2, 1);
+
+    // Assert
+    assert(share_tickets(0) == SHARE_DEFAULT_TICKETS && share_tickets(7) == 7);
+
+    assert(stride_result.current_cycle == 769);
+    assert(stride_processes[1].finished_time == 512 && stride_processes[0].finished_time == 768);
+    assert(fabs(stride_processes[0].entitled_time - 384.0) < 1e-6);
+    assert(fabs(stride_processes[1].entitled_time - 384.0) < 1e-6);
+
+    assert(lottery_result.current_cycle == 769 && lottery_processes[0].finished_time == 768);
+    assert(lottery_processes[1].finished_time >= 512 - 16 && lottery_processes[1].finished_time <= 512 + 16);
+
+    // Every cycle run is shared out, so the entitlements add up to the CPU time
+    double entitled = lottery_processes[0].entitled_time + lottery_processes[1].entitled_time;
+    assert(fabs(entitled - 768.0) < 1e-6);
+}
+
+/**
+IN: 2 ( 0 1000 300 1 5) ( 0 1000 300 1) then 3 ( 0 1000 100 1) ( 0 1000 100 1) ( 0 1000 100 1)
+Neither process blocks nor leaves the CPU idle. Weights 335 and 1024: the heavier one finishes at 398, so the
+lighter one ran the other 98 cycles, 300 * 335 / 1024 rounded. Equal weights share the CPU in slices of
+24 / 3 = 8 cycles, so the three processes finish within a slice of each other.
+**/
+void test_cfs_weighted_share()
+{
+    // Arrange
+    cfs_config_t config = {.target_latency = 24, .min_granularity = 3};
+    process_t weighted[] = {
+        {.A = 0, .B = 1000, .C = 300, .M = 1, .id = 0, .priority = 5},
+        {.A = 0, .B = 1000, .C = 300, .M = 1, .id = 1, .priority = 0},
+    };
+    process_t equal[] = {
+        {.A = 0, .B = 1000, .C = 100, .M = 1, .id = 0},
+        {.A = 0, .B = 1000, .C = 100, .M = 1, .id = 1},
+        {.A = 0, .B = 1000, .C = 100, .M = 1, .id = 2},
+    };
+
+    // Act
+    scheduler_result_t weighted_result = cfs(&TEST_CONTEXT, weighted, 2, &config);
+    scheduler_result_t equal_result = cfs(&TEST_CONTEXT, equal, 3, &config);
+
+    // Assert
+    assert(cfs_weight(5) == 335 && cfs_weight(0) == CFS_NICE_0_WEIGHT && cfs_weight(40) == 15);
+
+    assert(weighted_result.current_cycle == 601);
+    assert(weighted[1].finished_time == 398);
+    assert(weighted[0].finished_time == 600);
+    assert(weighted_result.total_number_of_cycles_spent_blocked == 0);
+
+    assert(equal_result.current_cycle == 301);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        assert(equal[i].finished_time >= 300 - 8 && equal[i].cpu_time == 100);
+    }
+}
+
+/**
+IN: 3 ( 0 100 10 1 0 30) ( 2 100 3 1 0 6) ( 0 100 2 1)
+Bursts cover the whole CPU time. The first process runs until the second arrives with an earlier deadline
+(8 against 30) and preempts it, and the process without a deadline only runs once the others are done.
+**/
+void test_edf_preempts_for_earlier_deadline()
+{
+    // Arrange
+    process_t processes[] = {
+        {.A = 0, .B = 100, .C = 10, .M = 1, .id = 0, .deadline = 30},
+        {.A = 2, .B = 100, .C = 3, .M = 1, .id = 1, .deadline = 6},
+        {.A = 0, .B = 100, .C = 2, .M = 1, .id = 2},
+    };
+
+    // Act
+    scheduler_result_t result = edf(&TEST_CONTEXT, processes, 3);
+
+    // Assert
+    assert(result.current_cycle == 16);
+    assert(processes[0].id == 0 && processes[0].finished_time == 13);
+    assert(processes[1].id == 2 && processes[1].finished_time == 15);
+    assert(processes[2].id == 1 && processes[2].finished_time == 5 && processes[2].waiting_time == 0);
+    assert(result.total_context_switches == 4 && result.total_preemptions == 1);
+}
+
+/**
+ Two high priority processes keep the CPU busy, aging lets the low priority process in before they finish
+**/
+void test_priority_aging()
+{
+    // Arrange
+    process_t aged[] = {
+        {.A = 0, .B = 1, .C = 20, .M = 1, .id = 0, .priority = 2},
+        {.A = 0, .B = 1, .C = 20, .M = 1, .id = 1, .priority = 2},
+        {.A = 0, .B = 1, .C = 5, .M = 1, .id = 2, .priority = 6},
+    };
+    process_t starved[3];
+    memcpy(starved, aged, sizeof(aged));
+
+    // Act
+    priority(&TEST_CONTEXT, aged, 3, false, 1);
+    priority(&TEST_CONTEXT, starved, 3, false, 0);
+
+    // Assert
+    assert(starved[2].finished_time > starved[0].finished_time);
+    assert(starved[2].finished_time > starved[1].finished_time);
+    assert(aged[2].finished_time < aged[0].finished_time);
+    assert(aged[2].finished_time < aged[1].finished_time);
+}
+
+/**
+ The traced Priority scheduler records every cycle and runs exactly like the untraced one
+**/
+void test_priority_traced()
+{
+    for (uint32_t seed = 1; seed <= 20; seed++)
+    {
+        // Arrange
+        const uint32_t n = 40;
+        process_t traced[40], plain[40];
+        random_workload(traced, n, seed);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            traced[i].priority = i % 5;
+        }
+        memcpy(plain, traced, sizeof(traced));
+        trace_log_t trace;
+        trace_log_init(&trace, n);
+
+        // Act
+        scheduler_result_t result = priority_traced(&TEST_CONTEXT, traced, n, true, 3, &trace);
+
+        // Assert
+        assert(trace.num_cycles == result.current_cycle);
+        assert_same_run(traced, result, plain, priority(&TEST_CONTEXT, plain, n, true, 3), n);
+
+        trace_log_free(&trace);
+    }
+}
+
+/**
+ A sweep counts down I/O bursts, wakes the processes whose burst is over and counts waiting time
+**/
+void test_process_table_sweep()
+{
+    // Arrange
+    process_t processes[] = {
+        {.status = BLOCKED, .io_burst = 1},
+        {.status = BLOCKED, .io_burst = 2},
+        {.status = READY, .waiting_time = 4},
+        {.status = RUNNING, .cpu_burst = 3},
+    };
+    process_table_t t;
+    process_table_init(&t, processes, 4, &TEST_CONTEXT);
+
+    // Act
+    uint32_t blocked = process_table_sweep(&t);
+    assert(t.size == 4);
+    process_table_store(&t, processes);
+
+    // Assert
+    assert(blocked == 2);
+    assert(processes[0].status == READY && processes[0].blocked_time == 1 && processes[0].waiting_time == 1);
+    assert(processes[1].status == BLOCKED && processes[1].io_burst == 1 && processes[1].blocked_time == 1);
+    assert(processes[2].status == READY && processes[2].waiting_time == 5);
+    assert(processes[3].status == RUNNING && processes[3].cpu_burst == 3);
+    assert(process_table_next_woken(&t, 0) == 0 && process_table_next_woken(&t, 1) == NO_PROCESS);
+    assert(process_table_next_ready(&t, 1) == 2 && process_table_next_ready(&t, 3) == 0);
+
+    process_table_free(&t);
+}
+
+/**
+ Every SIMD sweep kernel the CPU supports must match the scalar kernel, including the scalar tail
+**/
+void test_sweep_kernels_match_scalar()
+{
+    enum
+    {
+        N = 203
+    };
+    uint8_t status[N], expected_status[N];
+    uint32_t io[N], blocked[N], waiting[N], expected_io[N], expected_blocked[N], expected_waiting[N];
+    uint64_t woken[(N + 63) / 64], expected_woken[(N + 63) / 64];
+
+    sweep_kernel kernels[] = {SWEEP_SSE2, SWEEP_AVX2};
+    for (uint32_t k = 0; k < 2; k++)
+    {
+        if (!sweep_kernel_supported(kernels[k]))
+        {
+            continue;
+        }
+
+        for (uint32_t seed = 1; seed <= 50; seed++)
+        {
+            // Arrange
+            srand(seed);
+            uint32_t n = N - seed % 20;
+            for (uint32_t i = 0; i < n; i++)
+            {
+                status[i] = expected_status[i] = rand() % 5;
+                io[i] = expected_io[i] = rand() % 3;
+                blocked[i] = expected_blocked[i] = rand() % 100;
+                waiting[i] = expected_waiting[i] = rand() % 100;
+            }
+
+            // Act
+            uint32_t got = sweep_kernel_select(kernels[k])(status, io, blocked, waiting, woken, n);
+            uint32_t want = sweep_scalar(expected_status, expected_io, expected_blocked, expected_waiting, expected_woken, n);
+
+            // Assert
+            assert(got == want);
+            assert(memcmp(status, expected_status, n) == 0);
+            assert(memcmp(io, expected_io, sizeof(uint32_t) * n) == 0);
+            assert(memcmp(blocked, expected_blocked, sizeof(uint32_t) * n) == 0);
+            assert(memcmp(waiting, expected_waiting, sizeof(uint32_t) * n) == 0);
+            assert(memcmp(woken, expected_woken, sizeof(uint64_t) * ((n + 63) / 64)) == 0);
+        }
+    }
+}
+
+/// Reads a workload from sample_io/input the way the simulator does
+uint32_t read_sample_input(const char *path, process_t *processes, uint32_t capacity)
+{
+    FILE *f = fopen(path, "r");
+    assert(f != NULL);
+
+    uint32_t n = 0;
+    assert(fscanf(f, "%u", &n) == 1 && n <= capacity);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        processes[i] = (process_t){.id = i};
+        assert(fscanf(f, " (%u %u %u %u)", &processes[i].A, &processes[i].B, &processes[i].C, &processes[i].M) == 4);
+    }
+
+    fclose(f);
+    return n;
+}
+
+/// Runs every scheduler with one sweep kernel, writing each run into its own slice of `runs`
+void run_all_schedulers(sweep_kernel kernel, const process_t *input, uint32_t n, process_t *runs, scheduler_result_t *results)
+{
+    sched_context_t context = {.random = &TEST_RANDOM_TABLE, .sweep = kernel};
+    for (uint32_t s = 0; s < 5; s++)
+    {
+        memcpy(&runs[s * n], input, sizeof(process_t) * n);
+    }
+
+    results[0] = fcfs(&context, &runs[0 * n], n);
+    results[1] = sjf(&context, &runs[1 * n], n);
+    results[2] = rr(&context, &runs[2 * n], n, 2, false);
+    results[3] = priority(&context, &runs[3 * n], n, false, 8);
+    results[4] = priority(&context, &runs[4 * n], n, true, 8);
+}
+
+/**
+ The schedulers give the same results with the scalar and the SIMD sweep, on the sample inputs and randomized workloads
+**/
+void test_schedulers_match_across_sweep_kernels()
+{
+    process_t input[64];
+    process_t scalar[5 * 64], simd[5 * 64];
+    scheduler_result_t scalar_results[5], simd_results[5];
+
+    const char *samples[] = {"sample_io/input/input-1", "sample_io/input/input-2", "sample_io/input/input-3"};
+    for (uint32_t seed = 0; seed < 3 + 60; seed++)
+    {
+        uint32_t n = seed < 3 ? read_sample_input(samples[seed], input, 64) : 1 + seed % 64;
+        if (seed >= 3)
+        {
+            random_workload(input, n, seed);
+        }
+
+        run_all_schedulers(SWEEP_SCALAR, input, n, scalar, scalar_results);
+        run_all_schedulers(SWEEP_AUTO, input, n, simd, simd_results);
+
+        assert_same_runs(simd, simd_results, scalar, scalar_results, n, 5);
+    }
+}
+
+/* An allocator counting its blocks, to check a run frees everything it allocates */
+typedef struct
+{
+    uint32_t allocated; // Blocks handed out
+    uint32_t live;      // Blocks not freed yet
+} counting_allocator_t;
+
+static void *counting_alloc(void *user, size_t size, size_t alignment)
+{
+    counting_allocator_t *c = user;
+    c->allocated++;
+    c->live++;
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+static void counting_free(void *user, void *block)
+{
+    counting_allocator_t *c = user;
+    c->live--;
+    free(block);
+}
+
+#define NUM_CONTEXT_RUNS 12
+
+/// Runs every single-core scheduler and both other engines in a context, writing each run into its own slice of `runs`
+void run_in_context(const sched_context_t *context, const process_t *input, uint32_t n, process_t *runs,
+                    scheduler_result_t *results)
+{
+    for (uint32_t s = 0; s < NUM_CONTEXT_RUNS; s++)
+    {
+        memcpy(&runs[s * n], input, sizeof(process_t) * n);
+    }
+    mlfq_config_t mlfq_levels = mlfq_config(3, 2, 10);
+    cfs_config_t cfs_config = {.target_latency = 24, .min_granularity = 3};
+
+    results[0] = fcfs(context, &runs[0 * n], n);
+    results[1] = sjf(context, &runs[1 * n], n);
+    results[2] = srtf(context, &runs[2 * n], n);
+    results[3] = rr(context, &runs[3 * n], n, 2, false);
+    results[4] = priority(context, &runs[4 * n], n, true, 8);
+    results[5] = mlfq(context, &runs[5 * n], n, &mlfq_levels);
+    results[6] = cfs(context, &runs[6 * n], n, &cfs_config);
+    results[7] = edf(context, &runs[7 * n], n);
+    results[8] = lottery(context, &runs[8 * n], n, 2);
+    results[9] = stride(context, &runs[9 * n], n, 2);
+    results[10] = sjf_event(context, &runs[10 * n], n);
+    results[11] = rr_multicore(context, &runs[11 * n], n, 2, false, 4);
+}
+
+/**
+ Every scheduler takes all of its memory from the allocator of its context, frees all of it, and gives the same
+ results as with malloc
+**/
+void test_context_allocator()
+{
+    // Arrange
+    uint32_t n = 50;
+    process_t input[50];
+    random_workload(input, n, 7);
+
+    process_t *expected = malloc(sizeof(process_t) * NUM_CONTEXT_RUNS * n);
+    process_t *got = malloc(sizeof(process_t) * NUM_CONTEXT_RUNS * n);
+    scheduler_result_t expected_results[NUM_CONTEXT_RUNS], got_results[NUM_CONTEXT_RUNS];
+
+    counting_allocator_t counter = {0};
+    sched_context_t counted = {
+        .random = &TEST_RANDOM_TABLE,
+        .allocator = {.alloc = counting_alloc, .free = counting_free, .user = &counter},
+    };
+
+    // Act
+    run_in_context(&TEST_CONTEXT, input, n, expected, expected_results);
+    run_in_context(&counted, input, n, got, got_results);
+
+    // Assert
+    assert(counter.allocated >= NUM_CONTEXT_RUNS && counter.live == 0);
+    assert_same_runs(got, got_results, expected, expected_results, n, NUM_CONTEXT_RUNS);
+
+    free(expected);
+    free(got);
+}
+
+static void *failing_alloc(void *user, size_t size, size_t alignment)
+{
+    (void)user, (void)size, (void)alignment;
+    return NULL;
+}
+
+/**
+ An allocator running out of memory aborts the run, also in a build with NDEBUG where assert() does nothing
+**/
+void test_allocator_out_of_memory()
+{
+    // Arrange
+    sched_allocator_t failing = {.alloc = failing_alloc};
+    fflush(stdout);
+
+    // Act
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0)
+    {
+        freopen("/dev/null", "w", stderr);
+        sched_malloc(&failing, 4, sizeof(uint32_t));
+        _exit(0);
+    }
+    int status;
+    waitpid(child, &status, 0);
+
+    // Assert
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+}
+
+/* The runs of one thread of test_concurrent_contexts() */
+typedef struct
+{
+    const process_t *input;
+    uint32_t n;
+    counting_allocator_t counter;
+    process_t *runs;
+    scheduler_result_t results[NUM_CONTEXT_RUNS];
+} context_thread_t;
+
+void *run_context_thread(void *arg)
+{
+    context_thread_t *c = arg;
+    sched_context_t context = {
+        .random = &TEST_RANDOM_TABLE,
+        .allocator = {.alloc = counting_alloc, .free = counting_free, .user = &c->counter},
+    };
+    for (uint32_t k = 0; k < 20; k++)
+    {
+        run_in_context(&context, c->input, c->n, c->runs, c->results);
+    }
+    return NULL;
+}
+
+/**
+ Runs on several threads at once, each in its own context, share nothing: each allocator only sees its own runs,
+ and every run gives the results of a run on its own
+**/
+void test_concurrent_contexts()
+{
+    // Arrange
+    uint32_t n = 64;
+    process_t input[64];
+    random_workload(input, n, 11);
+
+    process_t *expected = malloc(sizeof(process_t) * NUM_CONTEXT_RUNS * n);
+    scheduler_result_t expected_results[NUM_CONTEXT_RUNS];
+    run_in_context(&TEST_CONTEXT, input, n, expected, expected_results);
+
+    context_thread_t threads[4];
+    pthread_t ids[4];
+
+    // Act
+    for (uint32_t t = 0; t < 4; t++)
+    {
+        threads[t] = (context_thread_t){.input = input, .n = n};
+        threads[t].runs = malloc(sizeof(process_t) * NUM_CONTEXT_RUNS * n);
+        assert(pthread_create(&ids[t], NULL, run_context_thread, &threads[t]) == 0);
+    }
+    for (uint32_t t = 0; t < 4; t++)
+    {
+        pthread_join(ids[t], NULL);
+    }
+
+    // Assert
+    for (uint32_t t = 0; t < 4; t++)
+    {
+        assert(threads[t].counter.live == 0 && threads[t].counter.allocated == threads[0].counter.allocated);
+        assert_same_runs(threads[t].runs, threads[t].results, expected, expected_results, n, NUM_CONTEXT_RUNS);
+        free(threads[t].runs);
+    }
+    free(expected);
+}
+
+/**
+ The ready queue pops the smallest key first and breaks ties on the lower index
+**/
+void test_ready_queue_order()
+{
+    // Arrange
+    ready_queue_t q;
+    ready_queue_init(&q, 6, NULL);
+
+    // Act
+    ready_queue_push(&q, 4, 3);
+    ready_queue_push(&q, 1, 7);
+    ready_queue_push(&q, 5, 3);
+    ready_queue_push(&q, 0, 7);
+    ready_queue_push(&q, 2, 1);
+
+    // Assert
+    assert(ready_queue_contains(&q, 4) && !ready_queue_contains(&q, 3));
+    assert(ready_queue_peek(&q) == 2);
+
+    uint32_t expected[] = {2, 4, 5, 0, 1};
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        assert(ready_queue_pop(&q) == expected[i]);
+    }
+    assert(ready_queue_empty(&q));
+    assert(!ready_queue_contains(&q, 4));
+
+    ready_queue_free(&q);
+}
+
+/**
+ Each level pops in FIFO order, better levels first, and a boost keeps that order on level 0
+**/
+void test_level_queue_order()
+{
+    // Arrange
+    level_queue_t q;
+    level_queue_init(&q, 6, NULL);
+
+    // Act
+    level_queue_push(&q, 2, 4);
+    level_queue_push(&q, 0, 1);
+    level_queue_push(&q, 2, 0);
+    level_queue_push(&q, 5, 3);
+    level_queue_push(&q, 0, 5);
+    level_queue_push(&q, 2, 2);
+    level_queue_remove(&q, 2, 0);
+
+    // Assert
+    assert(q.nonempty == (1u << 0 | 1u << 2 | 1u << 5));
+    assert(level_queue_first_level(&q) == 0);
+    assert(level_queue_pop(&q) == 1);
+    assert(level_queue_pop(&q) == 5);
+    assert(level_queue_first_level(&q) == 2);
+
+    level_queue_push(&q, 1, 0);
+    level_queue_merge_to_top(&q);
+    assert(q.nonempty == 1);
+
+    uint32_t expected[] = {0, 4, 2, 3};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        assert(level_queue_pop(&q) == expected[i]);
+    }
+    assert(level_queue_empty(&q));
+
+    level_queue_free(&q);
+}
+
+/// @brief Checks the red-black rules below x and returns its black height, every path to a leaf having as many
+static uint32_t rb_tree_black_height(const rb_tree_t *t, uint32_t x)
+{
+    if (x == t->nil)
+    {
+        return 1;
+    }
+    if (t->left[x] != t->nil)
+    {
+        assert(t->parent[t->left[x]] == x && rb_tree_less(t, t->left[x], x));
+    }
+    if (t->right[x] != t->nil)
+    {
+        assert(t->parent[t->right[x]] == x && rb_tree_less(t, x, t->right[x]));
+    }
+    assert(t->color[x] == RB_BLACK || (t->color[t->left[x]] == RB_BLACK && t->color[t->right[x]] == RB_BLACK));
+
+    uint32_t height = rb_tree_black_height(t, t->left[x]);
+    assert(height == rb_tree_black_height(t, t->right[x]));
+    return height + (t->color[x] == RB_BLACK);
+}
+
+/**
+ The Fenwick tree finds the holder of every unit of weight as a scan of the weights in index order would
+**/
+void test_fenwick_find()
+{
+    // Arrange
+    const uint32_t n = 100;
+    fenwick_t f;
+    fenwick_init(&f, n, NULL);
+    uint64_t weights[100] = {0};
+
+    // Act
+    uint64_t x = 7;
+    for (uint32_t step = 0; step < 2000; step++)
+    {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        uint32_t i = (uint32_t)(x >> 33) % n;
+        int64_t delta = weights[i] && x % 3 == 0 ? -(int64_t)weights[i] : (int64_t)((x >> 20) % 50);
+        fenwick_add(&f, i, delta);
+        weights[i] += (uint64_t)delta;
+
+        // Assert
+        uint64_t total = 0;
+        for (uint32_t k = 0; k < n; k++)
+        {
+            assert(fenwick_prefix(&f, k) == total);
+            total += weights[k];
+        }
+        assert(f.total == total);
+
+        for (uint64_t unit = (x >> 40) % 7; unit < total; unit += 1 + (x >> 45) % 23)
+        {
+            uint32_t holder = fenwick_find(&f, unit);
+            assert(holder < n && weights[holder] > 0);
+            assert(fenwick_prefix(&f, holder) <= unit && unit < fenwick_prefix(&f, holder) + weights[holder]);
+        }
+    }
+
+    fenwick_free(&f);
+}
+
+/**
+ Random inserts and removals keep the tree balanced and ordered, and its cached first process the smallest
+**/
+void test_rb_tree_order()
+{
+    // Arrange
+    const uint32_t n = 200;
+    rb_tree_t t;
+    rb_tree_init(&t, n, NULL);
+    bool queued[200] = {false};
+    uint64_t keys[200];
+
+    // Act
+    uint64_t x = 42;
+    for (uint32_t step = 0; step < 5000; step++)
+    {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        uint32_t i = (uint32_t)(x >> 33) % n;
+        if (queued[i])
+        {
+            rb_tree_remove(&t, i);
+        }
+        else
+        {
+            keys[i] = (x >> 20) % 64; // Few distinct keys, so the index tie-break matters
+            rb_tree_insert(&t, i, keys[i]);
+        }
+        queued[i] = !queued[i];
+
+        // Assert
+        assert(t.color[t.root] == RB_BLACK);
+        rb_tree_black_height(&t, t.root);
+
+        uint32_t size = 0;
+        uint32_t first = t.nil;
+        for (uint32_t k = 0; k < n; k++)
+        {
+            if (queued[k])
+            {
+                size++;
+                first = first == t.nil || keys[k] < keys[first] ? k : first;
+            }
+        }
+        assert(t.size == size);
+        assert(rb_tree_empty(&t) ? size == 0 : rb_tree_first(&t) == first);
+    }
+
+    uint64_t last = 0;
+    while (!rb_tree_empty(&t))
+    {
+        uint32_t i = rb_tree_pop_first(&t);
+        assert(keys[i] >= last);
+        last = keys[i];
+    }
+
+    rb_tree_free(&t);
+}
+
+/**
+ Loads the shipped random-numbers file and checks lookups line up with the file
+**/
+void test_random_table()
+{
+    // Arrange
+    random_table_t table;
+
+    // Act
+    int loaded = random_table_load(&table, RANDOM_NUMBER_FILE_NAME, true, NULL);
+
+    // Assert
+    assert(loaded);
+    assert(table.count == 100000);
+    assert(getRandNumFromTable(1, &table) == 1804289383);
+    assert(getRandNumFromTable(2, &table) == 846930886);
+    assert(getRandNumFromTable(SEED_VALUE, &table) == 1784639529);
+    assert(getRandNumFromTable(table.count + 1, &table) == RANDOM_FAIL_SAFE_VALUE);
+
+    // Loading a second time goes through the binary sidecar and must agree
+    random_table_t cached;
+    assert(random_table_load(&cached, RANDOM_NUMBER_FILE_NAME, true, NULL));
+    assert(cached.count == table.count);
+    assert(memcmp(cached.values, table.values, sizeof(uint32_t) * table.count) == 0);
+
+    random_table_free(&table);
+    random_table_free(&cached);
+}
+
+/**
+ The headers are included from test.c and test_link.c, which link together and run the same scheduler
+**/
+void test_headers_in_two_units()
+{
+    // Arrange
+    process_t here[2] = {{.A = 0, .B = 1, .C = 5, .M = 1, .id = 0}, {.A = 0, .B = 1, .C = 3, .M = 1, .id = 1}};
+    process_t there[2];
+    memcpy(there, here, sizeof(here));
+
+    // Act
+    scheduler_result_t expected = rr(&TEST_CONTEXT, here, 2, 2, false);
+    scheduler_result_t got = test_link_rr(&TEST_CONTEXT, there, 2, 2);
+
+    // Assert
+    assert_same_run(there, got, here, expected, 2);
+}
+
+/**
+ The binary sidecar is only written when the caller asks for it
+**/
+void test_random_table_write_cache()
+{
+    // Arrange
+    char path[] = "/tmp/random-numbersXXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    assert(write(fd, "7\n11\n", 5) == 5);
+    close(fd);
+    char cache_path[sizeof(path) + 4];
+    snprintf(cache_path, sizeof(cache_path), "%s%s", path, RANDOM_NUMBER_CACHE_SUFFIX);
+    struct stat st;
+
+    // Act
+    random_table_t table;
+    assert(random_table_load(&table, path, false, NULL));
+    int cached_without = stat(cache_path, &st) == 0;
+    random_table_free(&table);
+
+    assert(random_table_load(&table, path, true, NULL));
+    int cached_with = stat(cache_path, &st) == 0;
+
+    // Assert
+    assert(!cached_without);
+    assert(cached_with);
+    assert(table.count == 2);
+    assert(getRandNumFromTable(2, &table) == 11);
+
+    random_table_free(&table);
+    unlink(cache_path);
+    unlink(path);
+}
+
+#ifdef SCHED_PROFILE
+/**
+ The profile of a run adds up: RR runs one process at a time, so every cycle is either idle or a cycle of CPU
+ time, and the tick and event engines draw the same bursts
+**/
+void test_profile_counters()
+{
+    for (uint32_t seed = 0; seed < 20; seed++)
+    {
+        // Arrange
+        const uint32_t n = 40;
+        process_t tick[40], event[40];
+        random_workload(tick, n, seed);
+        memcpy(event, tick, sizeof(tick));
+
+        // Act
+        scheduler_result_t tick_result = rr(&TEST_CONTEXT, tick, n, 2, false);
+        scheduler_result_t event_result = rr_event(&TEST_CONTEXT, event, n, 2, false);
+
+        // Assert
+        uint64_t cpu_time = 0;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            cpu_time += tick[i].cpu_time;
+        }
+        assert(tick_result.profile.idle_cycles + cpu_time == tick_result.current_cycle);
+        assert(tick_result.profile.picks == tick_result.current_cycle);
+        assert(tick_result.profile.burst_draws == event_result.profile.burst_draws);
+        assert(event_result.profile.picks == event_result.total_context_switches);
+
+        uint64_t phases = 0;
+        for (uint32_t k = 0; k < NUM_PHASES; k++)
+        {
+            phases += tick_result.profile.phase_ns[k];
+        }
+        assert(phases <= tick_result.profile.total_ns);
+    }
+}
+#endif
+
+/**
+ Percentiles are exact for small values and within 1/32 above, never past the largest value
+**/
+void test_histogram_percentiles()
+{
+    // Arrange
+    histogram_t empty = {0};
+    histogram_t small = {0};
+    histogram_t large = {0};
+
+    // Act
+    for (uint32_t v = 0; v < HISTOGRAM_EXACT; v++)
+    {
+        histogram_record(&small, v);
+    }
+    for (uint32_t v = 1; v <= 100000; v++)
+    {
+        histogram_record(&large, v);
+    }
+
+    // Assert
+    assert(histogram_percentile(&empty, 0.5) == 0 && histogram_mean(&empty) == 0.0);
+
+    assert(small.count == HISTOGRAM_EXACT && small.max == HISTOGRAM_EXACT - 1);
+    assert(histogram_percentile(&small, 0.5) == HISTOGRAM_EXACT / 2 - 1);
+    assert(histogram_percentile(&small, 1.0) == HISTOGRAM_EXACT - 1);
+
+    double qs[] = {0.5, 0.9, 0.99, 0.999};
+    for (uint32_t k = 0; k < 4; k++)
+    {
+        uint32_t exact = (uint32_t)(qs[k] * 100000 + 0.5);
+        uint32_t p = histogram_percentile(&large, qs[k]);
+        assert(p >= exact && p <= exact + exact / 32);
+    }
+    assert(histogram_percentile(&large, 1.0) == 100000 && large.max == 100000);
+    assert(histogram_mean(&large) == 50000.5);
+}
+
+/**
+IN: 2 ( 0 1 5 1) ( 0 1 5 1)
+Under FCFS the first process is dispatched as it arrives and the second one a cycle later, so their response
+times are 0 and 1, like the cycles they waited before first running
+**/
+void test_response_time_from_dispatch()
+{
+    // Arrange
+    process_t tick[2] = {{.A = 0, .B = 1, .C = 5, .M = 1, .id = 0}, {.A = 0, .B = 1, .C = 5, .M = 1, .id = 1}};
+    process_t event[2];
+    memcpy(event, tick, sizeof(tick));
+
+    // Act
+    scheduler_result_t tick_result = fcfs(&TEST_CONTEXT, tick, 2);
+    scheduler_result_t event_result = fcfs_event(&TEST_CONTEXT, event, 2);
+
+    // Assert
+    assert(tick_result.response_times.count == 2);
+    assert(tick_result.response_times.sum == 1 && tick_result.response_times.max == 1);
+    assert(tick_result.response_times.buckets[0] == 1 && tick_result.response_times.buckets[1] == 1);
+    assert(memcmp(&event_result.response_times, &tick_result.response_times, sizeof(histogram_t)) == 0);
+}
+
+static int cmpr_uint32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ The latencies recorded while scheduling are those of the processes: one each, with percentiles within a
+ bucket of the exact ones
+**/
+void test_latency_matches_processes()
+{
+    for (uint32_t seed = 0; seed < 20; seed++)
+    {
+        // Arrange
+        const uint32_t n = 50;
+        process_t processes[50];
+        random_workload(processes, n, seed);
+        cfs_config_t config = {.target_latency = 24, .min_granularity = 3};
+
+        // Act
+        scheduler_result_t result = cfs(&TEST_CONTEXT, processes, n, &config);
+
+        // Assert
+        uint32_t turnaround[50], waiting[50];
+        for (uint32_t i = 0; i < n; i++)
+        {
+            turnaround[i] = (uint32_t)(processes[i].finished_time - processes[i].A);
+            waiting[i] = processes[i].waiting_time;
+        }
+        qsort(turnaround, n, sizeof(uint32_t), cmpr_uint32);
+        qsort(waiting, n, sizeof(uint32_t), cmpr_uint32);
+
+        assert(result.turnaround_times.count == n && result.waiting_times.count == n && result.io_times.count == n);
+        assert(result.response_times.count == result.total_started_processes);
+        assert(result.turnaround_times.max == turnaround[n - 1] && result.waiting_times.max == waiting[n - 1]);
+
+        // The 25th of 50 values is the median
+        uint32_t p50 = histogram_percentile(&result.turnaround_times, 0.5);
+        assert(p50 >= turnaround[24] && p50 <= turnaround[24] + turnaround[24] / 32);
+        p50 = histogram_percentile(&result.waiting_times, 0.5);
+        assert(p50 >= waiting[24] && p50 <= waiting[24] + waiting[24] / 32);
+    }
+}
+
+/**
+ The timer wheel expires deadlines in cycle order, across levels and with cancelled timers left out
+**/
+void test_timer_wheel_order()
+{
+    // Arrange
+    const uint32_t n = 512;
+    uint64_t deadline[512];
+    bool pending[512];
+
+    timer_wheel_t w;
+    timer_wheel_init(&w, n, 5, NULL);
+
+    uint32_t x = 2463534242u;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+
+        // Spread deadlines from the current level 0 slot to far up the wheel
+        deadline[i] = 5 + (x % 5 == 0 ? x % 64 : (uint64_t)x % (1ull << (6 + x % 30)));
+        pending[i] = true;
+        timer_wheel_insert(&w, i, deadline[i]);
+    }
+    for (uint32_t i = 0; i < n; i += 7)
+    {
+        timer_wheel_cancel(&w, i);
+        pending[i] = false;
+    }
+
+    // Act, Assert
+    assert(timer_wheel_next(&w, 4) == TIMER_WHEEL_NEVER);
+
+    uint64_t cycle;
+    uint32_t expired = 0;
+    while ((cycle = timer_wheel_next(&w, TIMER_WHEEL_NEVER)) != TIMER_WHEEL_NEVER)
+    {
+        // Nothing pending is earlier than the cycle reported
+        for (uint32_t i = 0; i < n; i++)
+        {
+            assert(!pending[i] || deadline[i] >= cycle);
+        }
+
+        uint32_t i;
+        while (timer_wheel_pop(&w, cycle, &i))
+        {
+            assert(pending[i] && deadline[i] == cycle);
+            pending[i] = false;
+            expired++;
+        }
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        assert(!pending[i]);
+    }
+    assert(expired == n - (n + 6) / 7);
+    assert(w.size == 0);
+
+    timer_wheel_free(&w);
+}
+
+scheduler_result_t run_fcfs_one_core(process_t *processes, uint32_t n)
+{
+    return fcfs_multicore(&TEST_CONTEXT, processes, n, 1);
+}
+
+scheduler_result_t run_rr_one_core(process_t *processes, uint32_t n)
+{
+    return rr_multicore(&TEST_CONTEXT, processes, n, 2, false, 1);
+}
+
+scheduler_result_t run_rr_one_core_preemptive(process_t *processes, uint32_t n)
+{
+    return rr_multicore(&TEST_CONTEXT, processes, n, 2, true, 1);
+}
+
+/**
+ With a single core the multi-core FCFS and RR schedulers must agree with fcfs() and rr()
+**/
+void test_multicore_single_core_matches()
+{
+    assert_same_on_random_workloads(run_fcfs_one_core, run_fcfs, 50);
+    assert_same_on_random_workloads(run_rr_one_core, run_rr, 50);
+    assert_same_on_random_workloads(run_rr_one_core_preemptive, run_rr_preemptive, 50);
+}
+
+/**
+IN: 3 ( 0 2 5 1) ( 0 1 1 1) ( 0 1 1 1)
+Processes 0 and 2 are queued on core 0 and process 1 on core 1. Process 1 finishes after one cycle,
+so core 1 steals process 2 while core 0 is still running process 0.
+**/
+void test_multicore_work_stealing()
+{
+    // Arrange
+    process_t processes[] = {
+        {.A = 0, .B = 2, .C = 5, .M = 1, .id = 0},
+        {.A = 0, .B = 1, .C = 1, .M = 1, .id = 1},
+        {.A = 0, .B = 1, .C = 1, .M = 1, .id = 2},
+    };
+
+    // Act
+    scheduler_result_t result = fcfs_multicore(&TEST_CONTEXT, processes, 3, 2);
+
+    // Assert
+    assert(result.num_cores == 2);
+    assert(result.total_finished_processes == 3);
+    assert(result.total_migrations == 1);
+    assert(result.core_migrations[0] == 0 && result.core_migrations[1] == 1);
+
+    assert(processes[1].finished_time == 1);
+    assert(processes[2].finished_time == 2);
+    assert(processes[2].waiting_time == 1);
+
+    // Every cycle a core is busy is a cycle of CPU time for some process
+    uint32_t cpu_time = processes[0].cpu_time + processes[1].cpu_time + processes[2].cpu_time;
+    assert(result.core_busy_cycles[0] + result.core_busy_cycles[1] == cpu_time);
+}
+
+/**
+ Loads sample input 3, which ends in free text after the last process
+**/
+void test_loader_sample_input()
+{
+    // Arrange
+    process_t *processes;
+    uint32_t n;
+    load_error_t err;
+
+    // Act
+    bool loaded = load_processes_file("sample_io/input/input-3", &processes, &n, &err);
+
+    // Assert
+    assert(loaded);
+    assert(n == 3);
+    assert(processes[2].A == 3 && processes[2].B == 1 && processes[2].C == 5 && processes[2].M == 1);
+    assert(processes[2].id == 2 && processes[2].priority == 0);
+
+    free(processes);
+}
+
+/**
+ The optional priority, deadline and tickets are read, and malformed input or a B of 0 is reported at its line
+ and column
+**/
+void test_loader_errors()
+{
+    process_t *processes;
+    uint32_t n;
+    load_error_t err;
+
+    const char *with_priority = "3\n(0 1 5 1 3) ( 4 2 6 1 ) (1 1 1 1 0 9 50)";
+    assert(load_processes_text(with_priority, strlen(with_priority), &processes, &n, &err));
+    assert(n == 3 && processes[0].priority == 3 && processes[1].priority == 0 && processes[1].A == 4);
+    assert(processes[0].deadline == 0 && processes[2].deadline == 9);
+    assert(processes[0].tickets == 0 && processes[2].tickets == 50);
+    free(processes);
+
+    const char *bad_field = "2 (0 1 5 1)\n  (0 1 x 1)";
+    assert(!load_processes_text(bad_field, strlen(bad_field), &processes, &n, &err));
+    assert(err.line == 2 && err.column == 8);
+    assert(processes == NULL && n == 0);
+
+    const char *too_few = "3 (0 1 5 1)";
+    assert(!load_processes_text(too_few, strlen(too_few), &processes, &n, &err));
+    assert(err.line == 1 && err.column == 12);
+
+    const char *zero_burst = "2 (0 1 5 1)\n(0 0 5 1)";
+    assert(!load_processes_text(zero_burst, strlen(zero_burst), &processes, &n, &err));
+    assert(err.line == 2 && err.column == 4);
+    assert(strstr(err.message, "at least 1") != NULL);
+
+    const char *zero_multiplier = "2 (0 3 5 0)\n(1 2 4 0)";
+    assert(!load_processes_text(zero_multiplier, strlen(zero_multiplier), &processes, &n, &err));
+    assert(err.line == 1 && err.column == 10);
+    assert(strstr(err.message, "multiplier M") != NULL && strstr(err.message, "at least 1") != NULL);
+
+    const char *overflow = "1 (4294967296 1 5 1)";
+    assert(!load_processes_text(overflow, strlen(overflow), &processes, &n, &err));
+    assert(err.line == 1 && err.column == 4);
+
+    assert(!load_processes_text("", 0, &processes, &n, &err));
+    assert(err.line == 1 && err.column == 1);
+}
+
+static bool same_workload(const process_t *a, const process_t *b, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (a[i].A != b[i].A || a[i].B != b[i].B || a[i].C != b[i].C || a[i].M != b[i].M ||
+            a[i].priority != b[i].priority || a[i].deadline != b[i].deadline || a[i].tickets != b[i].tickets ||
+            a[i].id != b[i].id)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ Every sample input survives text -> binary -> text unchanged, and loads the same from either form
+**/
+void test_workload_round_trip()
+{
+    const char *inputs[] = {"sample_io/input/input-1", "sample_io/input/input-2", "sample_io/input/input-3"};
+    char binary[] = "/tmp/workload_binXXXXXX";
+    char text[] = "/tmp/workload_txtXXXXXX";
+    close(mkstemp(binary));
+    close(mkstemp(text));
+
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        // Arrange
+        process_t *original, *from_binary, *from_text;
+        uint32_t n, n_binary, n_text;
+        load_error_t err;
+        assert(load_processes_file(inputs[k], &original, &n, &err));
+
+        // Act
+        assert(save_processes_binary(binary, original, n));
+        bool binary_loaded = load_processes_file(binary, &from_binary, &n_binary, &err);
+        assert(save_processes_text(text, from_binary, n_binary));
+        bool text_loaded = load_processes_file(text, &from_text, &n_text, &err);
+
+        // Assert
+        assert(binary_loaded && n_binary == n && same_workload(original, from_binary, n));
+        assert(text_loaded && n_text == n && same_workload(original, from_text, n));
+
+        free(original);
+        free(from_binary);
+        free(from_text);
+    }
+
+    unlink(binary);
+    unlink(text);
+}
+
+/**
+ Binary workloads use the narrowest field width and keep the priority only when there is one,
+ and truncated or unknown layouts or a B of 0 are rejected
+**/
+void test_workload_binary_layout()
+{
+    // Arrange
+    process_t wide[2] = {{.A = 0, .B = 1, .C = 70000, .M = 1}, {.A = 3, .B = 2, .C = 5, .M = 1, .priority = 7, .id = 1}};
+    process_t *loaded;
+    uint32_t n;
+    load_error_t err;
+    char binary[] = "/tmp/workload_binXXXXXX";
+    close(mkstemp(binary));
+
+    // Act
+    assert(save_processes_binary(binary, wide, 2));
+    FILE *f = fopen(binary, "rb");
+    uint8_t bytes[96];
+    size_t length = fread(bytes, 1, sizeof(bytes), f);
+    fclose(f);
+    unlink(binary);
+
+    // Assert
+    assert(length == sizeof(workload_header_t) + 2 * 5 * 4);
+    assert(bytes[offsetof(workload_header_t, num_fields)] == 5 && bytes[offsetof(workload_header_t, field_width)] == 4);
+    assert(load_processes_binary(bytes, length, &loaded, &n, &err));
+    assert(n == 2 && same_workload(wide, loaded, 2));
+    free(loaded);
+
+    assert(!load_processes_binary(bytes, length - 1, &loaded, &n, &err));
+    assert(loaded == NULL && n == 0);
+
+    bytes[offsetof(workload_header_t, field_width)] = 3;
+    assert(!load_processes_binary(bytes, length, &loaded, &n, &err));
+
+    bytes[offsetof(workload_header_t, field_width)] = 4;
+    bytes[offsetof(workload_header_t, version)] = WORKLOAD_VERSION + 1;
+    assert(!load_processes_binary(bytes, length, &loaded, &n, &err));
+
+    // B bounds a CPU burst from 1 up, so 0 is rejected
+    bytes[offsetof(workload_header_t, version)] = WORKLOAD_VERSION;
+    memset(bytes + sizeof(workload_header_t) + 5 * 4 + 4, 0, 4);
+    assert(!load_processes_binary(bytes, length, &loaded, &n, &err));
+    assert(loaded == NULL && n == 0);
+
+    // An I/O multiplier M of 0 is rejected as well
+    bytes[sizeof(workload_header_t) + 5 * 4 + 4] = 2;
+    memset(bytes + sizeof(workload_header_t) + 5 * 4 + 12, 0, 4);
+    assert(!load_processes_binary(bytes, length, &loaded, &n, &err));
+    assert(loaded == NULL && n == 0 && strstr(err.message, "multiplier M") != NULL);
+
+    // A deadline adds a sixth field
+    wide[0].deadline = 9;
+    assert(save_processes_binary(binary, wide, 2));
+    assert(load_processes_file(binary, &loaded, &n, &err));
+    f = fopen(binary, "rb");
+    length = fread(bytes, 1, sizeof(bytes), f);
+    fclose(f);
+    unlink(binary);
+    assert(length == sizeof(workload_header_t) + 2 * 6 * 4 && bytes[offsetof(workload_header_t, num_fields)] == 6);
+    assert(n == 2 && same_workload(wide, loaded, 2));
+    free(loaded);
+
+    // Tickets add a seventh field
+    wide[1].tickets = 300;
+    assert(save_processes_binary(binary, wide, 2));
+    assert(load_processes_file(binary, &loaded, &n, &err));
+    f = fopen(binary, "rb");
+    length = fread(bytes, 1, sizeof(bytes), f);
+    fclose(f);
+    unlink(binary);
+    assert(length == sizeof(workload_header_t) + 2 * 7 * 4 && bytes[offsetof(workload_header_t, num_fields)] == 7);
+    assert(n == 2 && same_workload(wide, loaded, 2));
+    free(loaded);
+}
+
+/**
+ Generated workloads are reproducible from the seed, stay within their bounds, and arrive in order
+ unless drawn uniformly
+**/
+void test_workload_generator()
+{
+    arrival_dist dists[] = {ARRIVAL_POISSON, ARRIVAL_BURSTY, ARRIVAL_UNIFORM};
+    for (uint32_t d = 0; d < 3; d++)
+    {
+        // Arrange
+        workload_params_t params = workload_params_default(1000);
+        params.arrival = dists[d];
+        params.max_priority = 4;
+        params.seed = 42;
+
+        workload_gen_t g1, g2;
+        workload_gen_init(&g1, &params);
+        workload_gen_init(&g2, &params);
+
+        uint32_t last_A = 0;
+        uint32_t same_cycle = 0;
+        bool in_order = true;
+        for (uint32_t i = 0; i < params.count; i++)
+        {
+            // Act
+            process_t p1, p2;
+            workload_gen_next(&g1, &p1);
+            workload_gen_next(&g2, &p2);
+
+            // Assert
+            assert(same_workload(&p1, &p2, 1));
+            assert(p1.id == i);
+            assert(p1.B >= 1 && p1.B <= params.max_B && p1.M >= 1 && p1.M <= params.max_M);
+            assert(p1.C >= params.min_C && p1.C <= params.max_C && p1.priority <= params.max_priority);
+
+            in_order &= p1.A >= last_A;
+            same_cycle += i > 0 && p1.A == last_A;
+            last_A = p1.A;
+        }
+
+        assert(in_order == (dists[d] != ARRIVAL_UNIFORM));
+        assert(dists[d] != ARRIVAL_BURSTY || same_cycle > params.count / 2);
+    }
+
+    // A different seed gives a different workload
+    workload_params_t params = workload_params_default(10);
+    workload_gen_t g1, g2;
+    workload_gen_init(&g1, &params);
+    params.seed++;
+    workload_gen_init(&g2, &params);
+
+    bool differs = false;
+    for (uint32_t i = 0; i < params.count; i++)
+    {
+        process_t p1, p2;
+        workload_gen_next(&g1, &p1);
+        workload_gen_next(&g2, &p2);
+        differs |= !same_workload(&p1, &p2, 1);
+    }
+    assert(differs);
+}
+
+/**
+ The writer formats integers and doubles exactly like printf, across chunk boundaries
+**/
+void test_writer_matches_printf()
+{
+    // Arrange
+    double doubles[] = {0, -0.0, 0.5, 1.0 / 3, 2.0 / 3, 0.0000005, 0.0000015, 0.0000025, 1.2345675, 999999.9999995,
+                        1e6, 123456789.25, -2.5, 1e300, NAN, INFINITY};
+    int64_t ints[] = {0, 1, -1, 9, 10, INT32_MAX, INT32_MIN, INT64_MAX, INT64_MIN};
+
+    char *written, *expected;
+    size_t written_length, expected_length;
+    FILE *stream = open_memstream(&written, &written_length);
+    FILE *reference = open_memstream(&expected, &expected_length);
+    writer_t *w = malloc(sizeof(writer_t));
+    writer_init(w, stream);
+
+    // Act
+    workload_params_t params = workload_params_default(0);
+    workload_gen_t g;
+    workload_gen_init(&g, &params);
+    for (uint32_t k = 0; k < 200000; k++)
+    {
+        double v = k < 16 ? doubles[k] : workload_uniform(&g) * (k % 2 ? 100 : 1e7) / (k % 3 + 1);
+        writer_double6(w, v);
+        writer_char(w, ' ');
+        writer_int(w, ints[k % 9]);
+        writer_str(w, "\n");
+        fprintf(reference, "%6f %" PRId64 "\n", v, ints[k % 9]);
+    }
+    writer_flush(w);
+    fclose(stream);
+    fclose(reference);
+
+    // Assert
+    assert(!w->failed);
+    assert(written_length == expected_length && memcmp(written, expected, expected_length) == 0);
+
+    free(w);
+    free(written);
+    free(expected);
+}
+
+/**
+ The trace of sample input 2 under FCFS matches sample_io/output/trace_and_summary/output-2
+**/
+void test_trace_sample_input2()
+{
+    // Arrange
+    process_t processes[2] = {{.A = 0, .B = 1, .C = 5, .M = 1, .id = 0}, {.A = 0, .B = 1, .C = 5, .M = 1, .id = 1}};
+    trace_log_t trace;
+    trace_log_init(&trace, 2);
+
+    char *text;
+    size_t length;
+    FILE *stream = open_memstream(&text, &length);
+    writer_t *w = malloc(sizeof(writer_t));
+    writer_init(w, stream);
+
+    // Act
+    fcfs_traced(&TEST_CONTEXT, processes, 2, &trace);
+    trace_render(&trace, w);
+    writer_flush(w);
+    fclose(stream);
+
+    // Assert
+    const char *expected =
+        "This detailed printout gives the state and remaining burst for each process\n"
+        "Before cycle\t0:\tunstarted \t0\tunstarted \t0\t\n"
+        "Before cycle\t1:\trunning \t1\tready   \t0\t\n"
+        "Before cycle\t2:\tblocked \t1\trunning \t1\t\n"
+        "Before cycle\t3:\trunning \t1\tblocked \t1\t\n"
+        "Before cycle\t4:\tblocked \t1\trunning \t1\t\n"
+        "Before cycle\t5:\trunning \t1\tblocked \t1\t\n"
+        "Before cycle\t6:\tblocked \t1\trunning \t1\t\n"
+        "Before cycle\t7:\trunning \t1\tblocked \t1\t\n"
+        "Before cycle\t8:\tblocked \t1\trunning \t1\t\n"
+        "Before cycle\t9:\trunning \t1\tblocked \t1\t\n"
+        "Before cycle\t10:\tterminated \t0\trunning \t1\t\n";
+    assert(length == strlen(expected) && memcmp(text, expected, length) == 0);
+
+    free(w);
+    free(text);
+    trace_log_free(&trace);
+}
+
+/**
+ The delta-encoded trace replays every snapshot it was given, whether the bursts count down or jump
+**/
+void test_trace_replays_snapshots()
+{
+    // Arrange
+    const char *names[] = {"unstarted ", "ready   ", "running ", "blocked ", "terminated "};
+    const uint32_t n = 5;
+    process_t processes[5] = {0};
+    process_table_t t;
+    process_table_init(&t, processes, n, &TEST_CONTEXT);
+
+    trace_log_t trace;
+    trace_log_init(&trace, n);
+
+    char *text, *expected;
+    size_t length, expected_length;
+    FILE *reference = open_memstream(&expected, &expected_length);
+    fprintf(reference, "This detailed printout gives the state and remaining burst for each process\n");
+
+    workload_params_t params = workload_params_default(0);
+    workload_gen_t g;
+    workload_gen_init(&g, &params);
+
+    // Act
+    for (uint32_t cycle = 0; cycle < 2000; cycle++)
+    {
+        trace_log_cycle(&trace, &t);
+        fprintf(reference, "Before cycle\t%u:\t", cycle);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            fprintf(reference, "%s\t%u\t", names[t.status[i]], trace_shown_burst(&t, i));
+        }
+        fprintf(reference, "\n");
+
+        // Mostly count the bursts down, sometimes move a process anywhere
+        for (uint32_t i = 0; i < n; i++)
+        {
+            t.cpu_burst[i] -= t.status[i] == RUNNING && t.cpu_burst[i];
+            t.io_burst[i] -= t.status[i] == BLOCKED && t.io_burst[i];
+            if (workload_uniform(&g) < 0.2)
+            {
+                t.status[i] = workload_between(&g, UNSTARTED, TERMINATED);
+                t.cpu_burst[i] = workload_between(&g, 0, 300);
+                t.io_burst[i] = workload_between(&g, 0, 300);
+            }
+        }
+    }
+    fclose(reference);
+
+    FILE *stream = open_memstream(&text, &length);
+    writer_t *w = malloc(sizeof(writer_t));
+    writer_init(w, stream);
+    trace_render(&trace, w);
+    writer_flush(w);
+    fclose(stream);
+
+    // Assert
+    assert(length == expected_length && memcmp(text, expected, length) == 0);
+    assert(trace.length < expected_length / 8);
+
+    free(w);
+    free(text);
+    free(expected);
+    trace_log_free(&trace);
+    process_table_free(&t);
+}
+
+int main()
+{
+    test_fcfs_input1();
+    test_fcfs_input2();
+    test_fcfs_input3();
+
+    test_sjf_input1();
+    test_sjf_input2();
+    test_sjf_input3();
+
+    test_rr_input1();
+    test_rr_input2();
+    test_rr_input3();
+    test_rr_blocks_every_cycle();
+    test_rr_quantum();
+
+    test_priority_input2();
+    test_priority_preemption();
+    test_priority_aging();
+    test_priority_traced();
+
+    test_srtf_preempts_on_arrival();
+    test_mlfq_demotes_and_preempts();
+    test_mlfq_promotes_and_boosts();
+    test_cfs_weighted_share();
+    test_lottery_and_stride_share();
+    test_edf_preempts_for_earlier_deadline();
+
+    test_event_matches_tick();
+    test_latency_matches_processes();
+    test_response_time_from_dispatch();
+#ifdef SCHED_PROFILE
+    test_profile_counters();
+#endif
+
+    test_multicore_single_core_matches();
+    test_multicore_work_stealing();
+
+    test_ready_queue_order();
+    test_level_queue_order();
+    test_rb_tree_order();
+    test_fenwick_find();
+    test_histogram_percentiles();
+    test_timer_wheel_order();
+    test_process_table_sweep();
+    test_sweep_kernels_match_scalar();
+    test_schedulers_match_across_sweep_kernels();
+    test_context_allocator();
+    test_allocator_out_of_memory();
+    test_concurrent_contexts();
+
+    test_random_table();
+    test_random_table_write_cache();
+    test_headers_in_two_units();
+    test_loader_sample_input();
+    test_loader_errors();
+    test_workload_round_trip();
+    test_workload_binary_layout();
+    test_workload_generator();
+    test_writer_matches_printf();
+    test_trace_sample_input2();
+    test_trace_replays_snapshots();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#define UNIT_TEST_ENV
+
+#include "scheduler.h"
+#include "event.h"
+#include "multicore.h"
+#include "timer_wheel.h"
+#include "loader.h"
+#include "sweep.h"
+#include "trace.h"
+#include "workload_gen.h"
+#include "writer.h"
+#include "histogram.h"
+
+/*
+ * A second translation unit of the unit tests, including every header test.c includes. The headers only
+ * define static functions and data, so unit_test links only if none of them is defined twice.
+ */
+
+/// @brief rr() as compiled into this translation unit, see test_headers_in_two_units()
+scheduler_result_t test_link_rr(const sched_context_t *context, process_t *processes, uint32_t total_num_of_process,
+                                uint8_t quantum)
+{
+    return rr(context, processes, total_num_of_process, quantum, false);
+}
@@ -0,0 +1,241 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "allocator.h"
+
+/*
+ * Hierarchical timer wheel holding one pending deadline per process (an arrival, an I/O completion, the
+ * end of a run...), keyed by cycle.
+ *
+ * Level l has 64 slots, each covering 64^l cycles. A timer is filed on the lowest level whose slot still
+ * tells its deadline apart from the current cycle, so level 0 holds the deadlines of the next 64 cycles
+ * exactly and every higher slot is emptied into the lower levels ("cascaded") when time reaches it. Inserting
+ * and cancelling are O(1), and a timer is moved at most once per level before it expires. A bitmap of the
+ * occupied slots of each level finds the next deadline without walking empty slots, which lets callers jump
+ * straight to it.
+ */
+
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_LEVELS 11 // 11 levels of 6 bits cover every 64 bit cycle
+
+#define TIMER_NONE UINT32_MAX          // End of a slot list
+#define TIMER_WHEEL_NEVER UINT64_MAX   // No deadline
+
+typedef struct
+{
+    uint64_t now; // The current cycle, every pending deadline is at or after it
+
+    uint64_t occupied[TIMER_WHEEL_LEVELS];                 // Bit s is set when slot s of the level holds timers
+    uint32_t head[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS]; // First timer of every slot
+
+    // Per timer id, 0 .. capacity - 1
+    uint64_t *deadline;
+    uint32_t *next;
+    uint32_t *prev;
+    uint16_t *where; // level * TIMER_WHEEL_SLOTS + slot, or TIMER_WHEEL_IDLE when not pending
+
+    uint32_t capacity;
+    uint32_t size; // The number of pending timers
+
+    const sched_allocator_t *allocator; // Where the per timer arrays come from
+} timer_wheel_t;
+
+#define TIMER_WHEEL_IDLE UINT16_MAX
+
+/// @brief Allocates a wheel for the timer ids 0 .. capacity - 1, starting at cycle `now`
+/// @param allocator where the per timer arrays come from, NULL for malloc
+static inline void timer_wheel_init(timer_wheel_t *w, uint32_t capacity, uint64_t now,
+                                    const sched_allocator_t *allocator)
+{
+    uint32_t n = capacity ? capacity : 1;
+
+    *w = (timer_wheel_t){.now = now, .capacity = capacity, .allocator = allocator};
+    w->deadline = sched_malloc(allocator, n, sizeof(uint64_t));
+    w->next = sched_malloc(allocator, n, sizeof(uint32_t));
+    w->prev = sched_malloc(allocator, n, sizeof(uint32_t));
+    w->where = sched_malloc(allocator, n, sizeof(uint16_t));
+
+    for (uint32_t l = 0; l < TIMER_WHEEL_LEVELS; l++)
+    {
+        for (uint32_t s = 0; s < TIMER_WHEEL_SLOTS; s++)
+        {
+            w->head[l][s] = TIMER_NONE;
+        }
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        w->where[i] = TIMER_WHEEL_IDLE;
+    }
+}
+
+static inline void timer_wheel_free(timer_wheel_t *w)
+{
+    sched_free(w->allocator, w->deadline);
+    sched_free(w->allocator, w->next);
+    sched_free(w->allocator, w->prev);
+    sched_free(w->allocator, w->where);
+    *w = (timer_wheel_t){0};
+}
+
+/// @brief Files a timer on the lowest level whose slots tell its deadline apart from now
+static inline void timer_wheel_file(timer_wheel_t *w, uint32_t id)
+{
+    uint64_t diff = w->deadline[id] ^ w->now;
+    uint32_t level = diff < TIMER_WHEEL_SLOTS ? 0 : (63 - __builtin_clzll(diff)) / TIMER_WHEEL_SLOT_BITS;
+    uint32_t slot = (w->deadline[id] >> (level * TIMER_WHEEL_SLOT_BITS)) & (TIMER_WHEEL_SLOTS - 1);
+
+    uint32_t head = w->head[level][slot];
+    w->next[id] = head;
+    w->prev[id] = TIMER_NONE;
+    if (head != TIMER_NONE)
+    {
+        w->prev[head] = id;
+    }
+    w->head[level][slot] = id;
+    w->where[id] = level * TIMER_WHEEL_SLOTS + slot;
+    w->occupied[level] |= 1ull << slot;
+}
+
+/// @brief Unlinks a pending timer from its slot
+static inline void timer_wheel_unlink(timer_wheel_t *w, uint32_t id)
+{
+    uint32_t level = w->where[id] / TIMER_WHEEL_SLOTS;
+    uint32_t slot = w->where[id] % TIMER_WHEEL_SLOTS;
+
+    if (w->prev[id] != TIMER_NONE)
+    {
+        w->next[w->prev[id]] = w->next[id];
+    }
+    else
+    {
+        w->head[level][slot] = w->next[id];
+    }
+    if (w->next[id] != TIMER_NONE)
+    {
+        w->prev[w->next[id]] = w->prev[id];
+    }
+
+    if (w->head[level][slot] == TIMER_NONE)
+    {
+        w->occupied[level] &= ~(1ull << slot);
+    }
+    w->where[id] = TIMER_WHEEL_IDLE;
+}
+
+static inline bool timer_wheel_pending(const timer_wheel_t *w, uint32_t id)
+{
+    return w->where[id] != TIMER_WHEEL_IDLE;
+}
+
+/// @brief Sets the timer of an id that has none pending. The deadline must not be before now.
+static inline void timer_wheel_insert(timer_wheel_t *w, uint32_t id, uint64_t deadline)
+{
+    assert(deadline >= w->now && !timer_wheel_pending(w, id));
+
+    w->deadline[id] = deadline;
+    timer_wheel_file(w, id);
+    w->size++;
+}
+
+/// @brief Cancels the pending timer of an id, if any
+static inline void timer_wheel_cancel(timer_wheel_t *w, uint32_t id)
+{
+    if (timer_wheel_pending(w, id))
+    {
+        timer_wheel_unlink(w, id);
+        w->size--;
+    }
+}
+
+/// @brief Finds the first occupied slot, the one holding the earliest deadlines
+/// @return the cycle the slot starts at, or TIMER_WHEEL_NEVER if the wheel is empty
+static inline uint64_t timer_wheel_first_slot(const timer_wheel_t *w, uint32_t *level, uint32_t *slot)
+{
+    for (uint32_t l = 0; l < TIMER_WHEEL_LEVELS; l++)
+    {
+        uint32_t shift = l * TIMER_WHEEL_SLOT_BITS;
+        uint32_t digit = (w->now >> shift) & (TIMER_WHEEL_SLOTS - 1);
+
+        // Level 0 slots before now are empty, higher levels only hold slots after the current one
+        uint64_t after = l == 0 ? ~0ull << digit : (digit == TIMER_WHEEL_SLOTS - 1 ? 0 : ~0ull << (digit + 1));
+        uint64_t bits = w->occupied[l] & after;
+        if (!bits)
+        {
+            continue;
+        }
+
+        *level = l;
+        *slot = __builtin_ctzll(bits);
+
+        uint32_t above = shift + TIMER_WHEEL_SLOT_BITS;
+        uint64_t base = above >= 64 ? 0 : (w->now >> above) << above;
+        return base | ((uint64_t)*slot << shift);
+    }
+    return TIMER_WHEEL_NEVER;
+}
+
+/**
+ * Finds the earliest pending deadline that is not after `limit`, cascading the higher levels on the way.
+ * Returns TIMER_WHEEL_NEVER if every pending deadline is after `limit`. Afterwards now may have moved
+ * forward, but never past the returned deadline nor past `limit`.
+ */
+static inline uint64_t timer_wheel_next(timer_wheel_t *w, uint64_t limit)
+{
+    for (;;)
+    {
+        uint32_t level, slot;
+        uint64_t start = timer_wheel_first_slot(w, &level, &slot);
+        if (start == TIMER_WHEEL_NEVER || start > limit)
+        {
+            return TIMER_WHEEL_NEVER;
+        }
+
+        // Level 0 slots hold a single deadline
+        if (level == 0)
+        {
+            return start;
+        }
+
+        // Nothing is due before the slot starts, so time can move there and spread its timers over the lower levels
+        uint32_t id = w->head[level][slot];
+        w->head[level][slot] = TIMER_NONE;
+        w->occupied[level] &= ~(1ull << slot);
+        w->now = start;
+
+        while (id != TIMER_NONE)
+        {
+            uint32_t next = w->next[id];
+            timer_wheel_file(w, id);
+            id = next;
+        }
+    }
+}
+
+/**
+ * Moves the wheel to cycle `cycle` and removes one timer expiring on it.
+ * `cycle` must not be after the deadline or the limit of the last timer_wheel_next() call.
+ * Returns whether a timer expired, its id is written to `id`.
+ */
+static inline bool timer_wheel_pop(timer_wheel_t *w, uint64_t cycle, uint32_t *id)
+{
+    assert(cycle >= w->now);
+    w->now = cycle;
+
+    uint32_t slot = cycle & (TIMER_WHEEL_SLOTS - 1);
+    if (!(w->occupied[0] & (1ull << slot)))
+    {
+        return false;
+    }
+
+    *id = w->head[0][slot];
+    timer_wheel_unlink(w, *id);
+    w->size--;
+    return true;
+}
+
+#endif // TIMER_WHEEL_H
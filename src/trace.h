@@ -0,0 +1,187 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "process.h"
+#include "process_table.h"
+#include "writer.h"
+
+/*
+ * Per-cycle trace of the tick schedulers: the state and remaining burst of every process before every
+ * cycle, as in sample_io/output/trace_and_summary. The burst shown is the CPU burst left while RUNNING,
+ * the I/O burst left while BLOCKED, and 0 otherwise.
+ *
+ * Rather than a snapshot per cycle, the log holds what a snapshot could not predict from the one before:
+ * a RUNNING or BLOCKED process is expected to have one cycle less of burst left and any other process to
+ * stay as it is, so only state changes (and bursts that do not count down) are stored. The log is a byte
+ * stream of varints, one record per cycle with changes:
+ *   cycle - cycle of the previous record
+ *   per change: index - previous index (from -1), then burst << 3 | status
+ *   0 to end the record
+ * trace_render() replays it into the text of the samples.
+ */
+
+/* A trace being recorded, or recorded */
+typedef struct
+{
+    uint32_t num_processes;
+    uint32_t num_cycles; // Snapshots recorded, the cycles 0 .. num_cycles - 1
+
+    uint8_t *bytes; // The encoded changes
+    size_t length;
+    size_t capacity;
+
+    uint64_t last_cycle; // Cycle of the last record
+
+    // The snapshot of the last cycle recorded
+    uint8_t *status;
+    uint32_t *burst;
+} trace_log_t;
+
+static inline void trace_log_init(trace_log_t *log, uint32_t num_processes)
+{
+    uint32_t n = num_processes ? num_processes : 1;
+
+    *log = (trace_log_t){.num_processes = num_processes, .capacity = 4096};
+    log->bytes = malloc(log->capacity);
+    log->status = calloc(n, sizeof(uint8_t));
+    log->burst = calloc(n, sizeof(uint32_t));
+}
+
+static inline void trace_log_free(trace_log_t *log)
+{
+    free(log->bytes);
+    free(log->status);
+    free(log->burst);
+    *log = (trace_log_t){0};
+}
+
+/// @brief The burst a process shows one cycle after showing `burst` in `status`, if nothing else happens
+static inline uint32_t trace_predict(uint8_t status, uint32_t burst)
+{
+    return (status == RUNNING || status == BLOCKED) && burst ? burst - 1 : burst;
+}
+
+static inline uint32_t trace_shown_burst(const process_table_t *t, uint32_t i)
+{
+    return t->status[i] == RUNNING ? t->cpu_burst[i] : t->status[i] == BLOCKED ? t->io_burst[i] : 0;
+}
+
+static inline void trace_put(trace_log_t *log, uint64_t v)
+{
+    if (log->length + 10 > log->capacity)
+    {
+        log->capacity *= 2;
+        log->bytes = realloc(log->bytes, log->capacity);
+    }
+    while (v >= 0x80)
+    {
+        log->bytes[log->length++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    log->bytes[log->length++] = (uint8_t)v;
+}
+
+static inline uint64_t trace_get(const uint8_t *bytes, size_t *pos)
+{
+    uint64_t v = 0;
+    for (uint32_t shift = 0;; shift += 7)
+    {
+        uint8_t b = bytes[(*pos)++];
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+        {
+            return v;
+        }
+    }
+}
+
+/// @brief Records the snapshot of the process table before its next cycle, cycle num_cycles
+static inline void trace_log_cycle(trace_log_t *log, const process_table_t *t)
+{
+    uint64_t cycle = log->num_cycles++;
+    int64_t previous = -1;
+
+    for (uint32_t i = 0; i < log->num_processes; i++)
+    {
+        uint8_t status = t->status[i];
+        uint32_t burst = trace_shown_burst(t, i);
+        uint32_t expected = cycle ? trace_predict(log->status[i], log->burst[i]) : 0;
+        if (status == log->status[i] && burst == expected)
+        {
+            log->burst[i] = burst;
+            continue;
+        }
+
+        if (previous < 0)
+        {
+            trace_put(log, cycle - log->last_cycle);
+            log->last_cycle = cycle;
+        }
+        trace_put(log, (uint64_t)(i - previous));
+        trace_put(log, (uint64_t)burst << 3 | status);
+        previous = i;
+
+        log->status[i] = status;
+        log->burst[i] = burst;
+    }
+
+    if (previous >= 0)
+    {
+        trace_put(log, 0);
+    }
+}
+
+static const char *const TRACE_STATUS_NAMES[] = {"unstarted ", "ready   ", "running ", "blocked ", "terminated "};
+
+/// @brief Writes the trace as in sample_io/output/trace_and_summary, from the line introducing it to the last cycle
+static inline void trace_render(const trace_log_t *log, writer_t *w)
+{
+    uint8_t *status = calloc(log->num_processes ? log->num_processes : 1, sizeof(uint8_t));
+    uint32_t *burst = calloc(log->num_processes ? log->num_processes : 1, sizeof(uint32_t));
+
+    writer_str(w, "This detailed printout gives the state and remaining burst for each process\n");
+
+    size_t pos = 0;
+    uint64_t next_record = log->length ? trace_get(log->bytes, &pos) : UINT64_MAX;
+    for (uint64_t cycle = 0; cycle < log->num_cycles; cycle++)
+    {
+        for (uint32_t i = 0; cycle && i < log->num_processes; i++)
+        {
+            burst[i] = trace_predict(status[i], burst[i]);
+        }
+
+        if (cycle == next_record)
+        {
+            int64_t i = -1;
+            for (uint64_t delta = trace_get(log->bytes, &pos); delta; delta = trace_get(log->bytes, &pos))
+            {
+                i += delta;
+                uint64_t v = trace_get(log->bytes, &pos);
+                status[i] = v & 7;
+                burst[i] = (uint32_t)(v >> 3);
+            }
+            next_record = pos < log->length ? cycle + trace_get(log->bytes, &pos) : UINT64_MAX;
+        }
+
+        writer_str(w, "Before cycle\t");
+        writer_uint(w, cycle);
+        writer_str(w, ":\t");
+        for (uint32_t i = 0; i < log->num_processes; i++)
+        {
+            writer_str(w, TRACE_STATUS_NAMES[status[i]]);
+            writer_char(w, '\t');
+            writer_uint(w, burst[i]);
+            writer_char(w, '\t');
+        }
+        writer_char(w, '\n');
+    }
+
+    free(status);
+    free(burst);
+}
+
+#endif // TRACE_H
@@ -0,0 +1,153 @@
+#ifndef WORKLOAD_GEN_H
+#define WORKLOAD_GEN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "process.h"
+
+/*
+ * Synthetic workloads, reproducible from a seed.
+ *
+ * Arrival times follow one of three processes, all with a mean of `mean_gap` cycles between arrivals:
+ *   ARRIVAL_POISSON: exponential gaps
+ *   ARRIVAL_BURSTY:  bursts of on average `burst_size` processes arriving on the same cycle, with
+ *                    exponential gaps of mean_gap * burst_size cycles between bursts
+ *   ARRIVAL_UNIFORM: arrival times drawn uniformly over count * mean_gap cycles, so not in order
+ * The burst bound B and the multiplier M are uniform over 1 .. max_B and 1 .. max_M, and the total CPU
+ * time C is Pareto distributed with shape `tail` from min_C on, cut off at max_C, so most processes are
+ * short and a few are very long. With max_priority set, the priority P is uniform over 0 .. max_priority.
+ * With deadline_slack set, the deadline D is that many times C (M + 1), about how long the process takes on
+ * an idle CPU, so a slack below 1 cannot be met and a slack well above 1 only under light load. With max_tickets
+ * set, the lottery tickets T are uniform over 1 .. max_tickets.
+ */
+
+typedef enum
+{
+    ARRIVAL_POISSON = 0,
+    ARRIVAL_BURSTY = 1,
+    ARRIVAL_UNIFORM = 2
+} arrival_dist;
+
+/* The shape of a workload */
+typedef struct
+{
+    uint32_t count;          // The number of processes
+    arrival_dist arrival;    // How arrival times are spread
+    double mean_gap;         // Mean cycles between arrivals
+    double burst_size;       // ARRIVAL_BURSTY: mean processes per burst
+    uint32_t max_B;          // B is uniform over 1 .. max_B
+    uint32_t min_C, max_C;   // C is Pareto distributed over min_C .. max_C
+    double tail;             // Shape of the Pareto distribution of C, lower is heavier
+    uint32_t max_M;          // M is uniform over 1 .. max_M
+    uint32_t max_priority;   // P is uniform over 0 .. max_priority, 0 for no priorities
+    double deadline_slack;   // D is deadline_slack * C * (M + 1), 0 for no deadlines
+    uint32_t max_tickets;    // T is uniform over 1 .. max_tickets, 0 for no tickets
+    uint64_t seed;
+} workload_params_t;
+
+/// @brief The default workload shape: Poisson arrivals every 2 cycles, B up to 5, C from 1 with shape 1.5, M up to 3
+static inline workload_params_t workload_params_default(uint32_t count)
+{
+    return (workload_params_t){
+        .count = count,
+        .arrival = ARRIVAL_POISSON,
+        .mean_gap = 2.0,
+        .burst_size = 8.0,
+        .max_B = 5,
+        .min_C = 1,
+        .max_C = 10000,
+        .tail = 1.5,
+        .max_M = 3,
+        .seed = 1,
+    };
+}
+
+/* Generator state, producing the processes of a workload one at a time */
+typedef struct
+{
+    workload_params_t params;
+    uint64_t state;      // splitmix64 state
+    double clock;        // Arrival time of the last process (ARRIVAL_POISSON, ARRIVAL_BURSTY)
+    uint32_t burst_left; // Processes left in the current burst (ARRIVAL_BURSTY)
+    uint32_t next_id;
+} workload_gen_t;
+
+static inline void workload_gen_init(workload_gen_t *g, const workload_params_t *params)
+{
+    *g = (workload_gen_t){.params = *params, .state = params->seed};
+}
+
+/// @brief splitmix64, small and fast with good statistical quality
+static inline uint64_t workload_rand(workload_gen_t *g)
+{
+    uint64_t z = (g->state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/// @brief Uniform over [0, 1)
+static inline double workload_uniform(workload_gen_t *g)
+{
+    return (workload_rand(g) >> 11) * 0x1.0p-53;
+}
+
+/// @brief Uniform over lo .. hi
+static inline uint32_t workload_between(workload_gen_t *g, uint32_t lo, uint32_t hi)
+{
+    return lo + (uint32_t)(workload_uniform(g) * ((double)hi - lo + 1));
+}
+
+static inline double workload_exponential(workload_gen_t *g, double mean)
+{
+    return -mean * log1p(-workload_uniform(g));
+}
+
+static inline uint32_t workload_clamp(double v, uint32_t lo, uint32_t hi)
+{
+    return v < lo ? lo : v > hi ? hi : (uint32_t)v;
+}
+
+static inline uint32_t workload_next_arrival(workload_gen_t *g)
+{
+    const workload_params_t *w = &g->params;
+    switch (w->arrival)
+    {
+    case ARRIVAL_UNIFORM:
+        return workload_clamp(workload_uniform(g) * w->count * w->mean_gap, 0, UINT32_MAX);
+
+    case ARRIVAL_BURSTY:
+        if (g->burst_left == 0)
+        {
+            // Geometric burst sizes with mean burst_size, the whole burst arrives on one cycle
+            double size = w->burst_size > 1 ? w->burst_size : 1;
+            double extra = size > 1 ? floor(log1p(-workload_uniform(g)) / log1p(-1 / size)) : 0;
+            g->burst_left = 1 + workload_clamp(extra, 0, UINT32_MAX - 1);
+            g->clock += workload_exponential(g, w->mean_gap * size);
+        }
+        g->burst_left--;
+        return workload_clamp(g->clock, 0, UINT32_MAX);
+
+    default:
+        g->clock += workload_exponential(g, w->mean_gap);
+        return workload_clamp(g->clock, 0, UINT32_MAX);
+    }
+}
+
+/// @brief Generates the next process of the workload, numbered from 0 like a loaded input
+static inline void workload_gen_next(workload_gen_t *g, process_t *p)
+{
+    const workload_params_t *w = &g->params;
+
+    *p = (process_t){.id = g->next_id++};
+    p->A = workload_next_arrival(g);
+    p->B = workload_between(g, 1, w->max_B);
+    p->C = workload_clamp(w->min_C / pow(1 - workload_uniform(g), 1 / w->tail), w->min_C, w->max_C);
+    p->M = workload_between(g, 1, w->max_M);
+    p->priority = w->max_priority ? workload_between(g, 0, w->max_priority) : 0;
+    p->deadline = workload_clamp(ceil(w->deadline_slack * p->C * (p->M + 1.0)), 0, UINT32_MAX);
+    p->tickets = w->max_tickets ? workload_between(g, 1, w->max_tickets) : 0;
+}
+
+#endif // WORKLOAD_GEN_H
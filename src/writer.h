@@ -0,0 +1,159 @@
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+/*
+ * Buffered text writer for the reports.
+ *
+ * Text is formatted straight into a fixed buffer inside the writer, which is handed to the stream with a
+ * single fwrite() whenever it fills up, so writing a report allocates nothing and costs one call per chunk
+ * instead of one printf() per field. Integers are formatted by hand. Doubles are printed like printf("%6f")
+ * by rounding the value times 10^6 to an integer, which is exact unless the value is large or within
+ * rounding error of a tie, and those rare cases fall back to snprintf(), so the text is byte-identical to
+ * printf().
+ */
+
+#define WRITER_BUFFER_SIZE (1 << 16)
+#define WRITER_MAX_FIELD 64 // Longest formatted number
+
+typedef struct
+{
+    FILE *stream;
+    size_t length; // Bytes buffered
+    bool failed;   // Whether a write to the stream failed
+    char buffer[WRITER_BUFFER_SIZE];
+} writer_t;
+
+static inline void writer_init(writer_t *w, FILE *stream)
+{
+    w->stream = stream;
+    w->length = 0;
+    w->failed = false;
+}
+
+/// @brief Hands the buffered text to the stream
+static inline void writer_flush(writer_t *w)
+{
+    if (w->length && fwrite(w->buffer, 1, w->length, w->stream) != w->length)
+    {
+        w->failed = true;
+    }
+    w->length = 0;
+}
+
+/// @brief Room for n <= WRITER_MAX_FIELD more bytes, to be committed by advancing length
+static inline char *writer_reserve(writer_t *w, size_t n)
+{
+    if (w->length + n > WRITER_BUFFER_SIZE)
+    {
+        writer_flush(w);
+    }
+    return w->buffer + w->length;
+}
+
+static inline void writer_bytes(writer_t *w, const char *bytes, size_t n)
+{
+    if (n > WRITER_BUFFER_SIZE - w->length)
+    {
+        writer_flush(w);
+        if (n > WRITER_BUFFER_SIZE)
+        {
+            w->failed |= fwrite(bytes, 1, n, w->stream) != n;
+            return;
+        }
+    }
+    memcpy(w->buffer + w->length, bytes, n);
+    w->length += n;
+}
+
+static inline void writer_str(writer_t *w, const char *s)
+{
+    writer_bytes(w, s, strlen(s));
+}
+
+static inline void writer_char(writer_t *w, char c)
+{
+    *writer_reserve(w, 1) = c;
+    w->length++;
+}
+
+/// @brief Writes an unsigned integer in decimal, like printf("%u")
+static inline void writer_uint(writer_t *w, uint64_t v)
+{
+    char digits[20];
+    uint32_t n = 0;
+    do
+    {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+
+    char *out = writer_reserve(w, n);
+    for (uint32_t k = 0; k < n; k++)
+    {
+        out[k] = digits[n - 1 - k];
+    }
+    w->length += n;
+}
+
+/// @brief Writes a signed integer in decimal, like printf("%i")
+static inline void writer_int(writer_t *w, int64_t v)
+{
+    if (v < 0)
+    {
+        writer_char(w, '-');
+        writer_uint(w, (uint64_t)0 - (uint64_t)v);
+    }
+    else
+    {
+        writer_uint(w, (uint64_t)v);
+    }
+}
+
+/// @brief Writes a double like printf("%6f"): at least 6 wide, 6 decimals, rounded to nearest
+static inline void writer_double6(writer_t *w, double v)
+{
+    // v * 10^6 is computed with an error below 2^-13 in this range, so its fraction decides the rounding
+    // unless it is that close to a half
+    if (!signbit(v) && v < 1e6)
+    {
+        double scaled = v * 1e6;
+        double whole = floor(scaled);
+        double fraction = scaled - whole;
+        if (fabs(fraction - 0.5) > 1e-3)
+        {
+            uint64_t micros = (uint64_t)whole + (fraction > 0.5);
+            writer_uint(w, micros / 1000000);
+
+            char *out = writer_reserve(w, 7);
+            out[0] = '.';
+            uint32_t decimals = micros % 1000000;
+            for (int k = 6; k >= 1; k--)
+            {
+                out[k] = (char)('0' + decimals % 10);
+                decimals /= 10;
+            }
+            w->length += 7;
+            return;
+        }
+    }
+
+    char *out = writer_reserve(w, WRITER_MAX_FIELD);
+    int n = snprintf(out, WRITER_MAX_FIELD, "%6f", v);
+    if (n >= 0 && n < WRITER_MAX_FIELD)
+    {
+        w->length += n;
+        return;
+    }
+
+    // Too wide for a field of the buffer, such as 1e300
+    writer_flush(w);
+    w->failed |= fprintf(w->stream, "%6f", v) < 0;
+}
+
+#endif // WRITER_H